@@ -14,6 +14,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -0,0 +1,43 @@
+#ifndef FIELDS_H
+#define FIELDS_H
+
+// Every game field exposed to the mods is declared here and only here.
+// Columns: object, C++ name (get<name>/set<name>), lua name, type (int/wstring), access (rw/ro), offset chain from the object root
+// The getters/setters, the lua properties and the per tick read plan are all generated from these tables (see fieldregistry.h)
+
+#define MODAPI_PLAYER_FIELDS(X) \
+    X(Player, money, "money", int, rw, 0x174) \
+    X(Player, maxcargo, "maxcargo", int, rw, 0x154, 0x0) \
+    X(Player, maxshiphealth, "maxhealth", int, rw, 0x154, 0x4) \
+    X(Player, cargo, "cargo", int, rw, 0x154, 0x10) \
+    X(Player, shiparmor, "armor", int, rw, 0x154, 0x20) \
+    X(Player, enemieskilled, "enemieskilled", int, rw, 0x188) \
+    X(Player, level, "level", int, rw, 0x190) \
+    X(Player, visitedstations, "visitedstations", int, rw, 0x198) \
+    X(Player, cargotookcount, "cargotookcount", int, rw, 0x1A8)
+
+#define MODAPI_SYSTEM_FIELDS(X) \
+    X(System, id, "id", int, rw, 0x168, 0x14) \
+    X(System, risklevel, "risk", int, rw, 0x168, 0x18) \
+    X(System, faction, "faction", int, rw, 0x168, 0x1C) \
+    X(System, mapcoordinatex, "mapcoordinate_x", int, rw, 0x168, 0x20) \
+    X(System, mapcoordinatey, "mapcoordinate_y", int, rw, 0x168, 0x24) \
+    X(System, mapcoordinatez, "mapcoordinate_z", int, rw, 0x168, 0x28) \
+    X(System, jumpgatestationid, "jumpgatestationid", int, rw, 0x168, 0x2C)
+
+#define MODAPI_STATION_FIELDS(X) \
+    X(Station, name, "name", wstring, rw, 0x160, 0x0, 0x0) \
+    X(Station, id, "id", int, rw, 0x160, 0x8) \
+    X(Station, techlevel, "level", int, rw, 0x160, 0x1C)
+
+#define MODAPI_MISSION_FIELDS(X) \
+    X(Mission, completedsidemissions, "completedsidemissions", int, rw, 0x18C) \
+    X(Mission, id, "id", int, rw, 0x1B0)
+
+#define MODAPI_FIELDS(X) \
+    MODAPI_PLAYER_FIELDS(X) \
+    MODAPI_SYSTEM_FIELDS(X) \
+    MODAPI_STATION_FIELDS(X) \
+    MODAPI_MISSION_FIELDS(X)
+
+#endif
\ No newline at end of file
@@ -14,6 +14,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -21,31 +37,9 @@
 #include <Game/asset.h>
 
 class Player {
-    private:
-        static inline uintptr_t player = 0;
     public:
         static void init(void);
-        static int getmoney(void);
-        static void setmoney(int value);
-        static int getmaxcargo(void);
-        static void setmaxcargo(int value);
-        static int getcargo(void);
-        static void setcargo(int value);
-        static int getshiparmor(void);
-        static void setshiparmor(int value);
-        static int getmaxshiphealth(void);
-        static void setmaxshiphealth(int value);
-        static int getenemieskilled(void);
-        static void setenemieskilled(int value);
-        static int getlevel(void);
-        static void setlevel(int value);
-        static int getvisitedstations(void);
-        static void setvisitedstations(int value);
-        static int getjumpgateusedcount(void);
-        static void setjumpgateusedcount(int value);
-        static int getcargotookcount(void);
-        static void setcargotookcount(int value);
-
+        MODAPI_PLAYER_FIELDS(MODAPI_FIELD_DECLARE)
         static bool hasshiparmor(void);
 };
 #endif
\ No newline at end of file
@@ -14,6 +14,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -21,15 +37,8 @@
 #include <Game/asset.h>
 
 class Station {
-    private:
-        static inline uintptr_t station = 0;
     public:
         static void init(void);
-        static int getid(void);
-        static void setid(int value);
-        static std::string getname(void);
-        static void setname(const std::string value);
-        static int gettechlevel(void);
-        static void settechlevel(int value);
+        MODAPI_STATION_FIELDS(MODAPI_FIELD_DECLARE)
 };
 #endif
\ No newline at end of file
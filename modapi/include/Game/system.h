@@ -14,6 +14,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -21,24 +37,9 @@
 #include <Game/asset.h>
 
 class System {
-    private:
-        static inline uintptr_t system = 0;
     public:
         static void init(void);
-        static int getid(void);
-        static void setid(int value);
-        static int getrisklevel(void);
-        static void setrisklevel(int value);
-        static int getfaction(void);
-        static void setfaction(int value);
-        static int getjumpgatestationid(void);
-        static void setjumpgatestationid(int value);
-        static int getmapcoordinatex(void);
-        static void setmapcoordinatex(int value);
-        static int getmapcoordinatey(void);
-        static void setmapcoordinatey(int value);
-        static int getmapcoordinatez(void);
-        static void setmapcoordinatez(int value);
+        MODAPI_SYSTEM_FIELDS(MODAPI_FIELD_DECLARE)
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef CHANGESAMPLER_H
+#define CHANGESAMPLER_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "fieldregistry.h"
+#include "spscqueue.h"
+
+// Watches the fields behind the change events (OnSystemChanged, OnMoneyChanged) from its own thread,
+// much faster than the tick, and queues every change it sees for the tick to dispatch.
+// A slow mod only delays the events, the changes made meanwhile are still in the queue.
+// When the queue is full the latest value of a field is kept aside and queued as soon as there is room,
+// so the mods always end up with the current value, only the steps in between are lost (and counted).
+// The same thread takes the samples of the FieldSeries.
+class ChangeSampler {
+    public:
+        struct Change {
+            FieldId id;
+            int value;
+            int previous;
+            // tick running when the change was seen
+            uint64_t tick;
+            // microseconds, steady clock
+            int64_t timestamp;
+        };
+        static constexpr size_t QUEUE_SIZE = 1024;
+    private:
+        struct Watch {
+            FieldId id;
+            bool known;
+            // last value read, last value queued
+            int value;
+            int queued;
+            // a change not queued yet
+            bool pending;
+        };
+        static inline SpscQueue<Change, QUEUE_SIZE> queue;
+        static inline std::vector<Watch> watches;
+        static inline std::thread sampler;
+        static inline std::atomic<bool> running{ false };
+        static inline std::atomic<uint64_t> dropped{ 0 };
+        static inline std::chrono::microseconds period{ 1000 };
+
+        static int64_t getnow(void);
+        static void setup(void);
+        static void sample(Watch& watch, int64_t now);
+        static void samplerloop(void);
+    public:
+        static void start(void);
+        static void stop(void);
+        // One round of samples on the calling thread, for the headless runner that doesn't start the thread
+        static void poll(void);
+        // Tick only
+        static bool take(Change& change);
+        // Changes that were merged into a later one because the queue was full, since the last call
+        static uint64_t takedropped(void);
+        // Samples per second of the thread, nothing can be sampled faster than that
+        static double getrate(void);
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+#include <map>
+#include <string>
+#include <vector>
+
+// modapi.cfg in the game folder, one "key = value" per line, # starts a comment
+class Config {
+    private:
+        static inline std::map<std::string, std::string> values;
+    public:
+        static bool load(const std::string& filepath);
+        // Overrides a key as if it was in the file, the headless runner fills in what its fake game needs
+        static void set(const std::string& key, const std::string& value);
+        static bool has(const std::string& key);
+        static std::string getstring(const std::string& key, const std::string& fallback);
+        static int getint(const std::string& key, int fallback);
+        static bool getbool(const std::string& key, bool fallback);
+        // Comma separated offsets ("0x20AD6C, 0x168"), empty when the key is missing or malformed
+        static std::vector<unsigned int> getoffsets(const std::string& key);
+};
+#endif
\ No newline at end of file
@@ -10,10 +10,28 @@
 #include <sol/sol.hpp>
 #include <map>
 #include <string>
+#include <atomic>
+#include <chrono>
 #include "modapi_utils.h"
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -21,30 +39,82 @@
 #include <Game/asset.h>
 
 class EventManager {
+    public:
+        struct Listener {
+            int mod;
+            sol::protected_function callback;
+            int overruns = 0;
+            bool disabled = false;
+        };
+        // Time spent in the lua code of each mod, in microseconds
+        struct CallStats {
+            uint64_t calls = 0;
+            int64_t time = 0;
+            int64_t worst = 0;
+            std::string worstname;
+            int overruns = 0;
+        };
+        // Runs a mod callback as its mod and under the Watchdog budget, logs lua errors with the mod name, kind/name only describe the callback in the error.
+        // A listener that keeps running over its budget is disabled.
+        template <typename... Args>
+        static bool call(Listener& listener, std::string_view kind, std::string_view name, Args&&... args)
+        {
+            if (listener.disabled)
+                return false;
+            ModContext::Scope scope(listener.mod);
+            lua_State* L = listener.callback.lua_state();
+            auto start = std::chrono::steady_clock::now();
+            Watchdog::begin(L);
+            auto result = listener.callback(std::forward<Args>(args)...);
+            bool aborted = Watchdog::end(L);
+            record(listener.mod, kind, name, std::chrono::steady_clock::now() - start, aborted);
+            if (!result.valid()) {
+                sol::error err = result;
+                Logger::error(ModContext::getname(listener.mod), "Lua Error in {} '{}': {}", kind, name, err.what());
+                if (aborted && ++listener.overruns >= Watchdog::getmaxoverruns()) {
+                    listener.disabled = true;
+                    Logger::error(ModContext::getname(listener.mod), "{} '{}' ran over its budget {} times, it won't be called anymore", kind, name, listener.overruns);
+                }
+                return false;
+            }
+            return true;
+        }
     private:
-        static std::map<std::string, std::vector<sol::protected_function>> listeners;
+        static std::map<std::string, std::vector<Listener>> listeners;
+        // RegisterEvent from a callback would grow the vector trigger is walking, those listeners wait for the end of the loop
+        static inline bool dispatching = false;
+        static inline std::vector<std::pair<std::string, Listener>> deferred;
+        static inline std::atomic<uint64_t> tick{ 0 };
+        static inline std::vector<CallStats> callstats;
         template <typename... Args>
         static void trigger(std::string eventname, Args&&... args)
         {
-            if (listeners.find(eventname) == listeners.end())
+            auto it = listeners.find(eventname);
+            if (it == listeners.end())
                 return;
 
-            for (auto& func : listeners[eventname]) {
-                auto result = func(std::forward<Args>(args)...);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    std::cerr << "[EventManager] Lua Error in event '" << eventname << "': " << err.what() << std::endl;
-                }
-            }
+            dispatching = true;
+            for (auto& listener : it->second)
+                call(listener, "event", eventname, args...);
+            dispatching = false;
+            adddeferred();
         }
+        static void adddeferred(void);
         static void update_event(void);
-        static void systemchanged_event(void);
-        static void moneychanged_event(void);
+        static void changes_event(void);
+        static void phase_event(void);
         static void ingame_event(void);
         static void mainmenu_event(void);
+        static void telemetry_event(void);
     public:
         static void addlistener(std::string eventname, sol::protected_function callback);
         static void trigger_events(void);
+        // Ticks started so far, readable from any thread
+        static uint64_t gettick(void);
+        static void record(int mod, std::string_view kind, std::string_view name, std::chrono::steady_clock::duration elapsed, bool aborted);
+        static const CallStats& getcallstats(int mod);
+        // Seconds on the steady clock with microsecond precision, the time given to the change events
+        static double getseconds(int64_t microseconds);
         static void clearlisteners(void);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+#ifndef FIELDREGISTRY_H
+#define FIELDREGISTRY_H
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <Game/fields.h>
+#include "seqlock.h"
+
+enum class FieldObject { Player, System, Station, Mission, Count };
+enum class FieldType { Int, WString };
+enum class FieldAccess { ReadOnly, ReadWrite };
+
+enum class FieldId {
+#define MODAPI_FIELD_ID(object, name, ...) object##_##name,
+    MODAPI_FIELDS(MODAPI_FIELD_ID)
+#undef MODAPI_FIELD_ID
+    Count
+};
+
+struct FieldInfo {
+    FieldObject object;
+    const char* objectname;
+    const char* luaname;
+    FieldType type;
+    FieldAccess access;
+    std::vector<unsigned int> offsets;
+};
+
+// Int fields as read by one tick, published for the other threads (FieldRegistry::getpublished)
+struct FieldSnapshot {
+    // bumped only when a value or a validity changed
+    uint64_t generation;
+    // microseconds, steady clock
+    int64_t timestamp;
+    // bit n set when field n could be read
+    uint64_t validmask;
+    int values[(size_t)FieldId::Count];
+};
+
+#define MODAPI_FIELD_CTYPE_int int
+#define MODAPI_FIELD_CTYPE_wstring std::string
+#define MODAPI_FIELD_CTYPE(type) MODAPI_FIELD_CTYPE_##type
+#define MODAPI_FIELD_KIND_int FieldType::Int
+#define MODAPI_FIELD_KIND_wstring FieldType::WString
+#define MODAPI_FIELD_ACCESS_rw FieldAccess::ReadWrite
+#define MODAPI_FIELD_ACCESS_ro FieldAccess::ReadOnly
+
+// Goes inside the game object class: MODAPI_PLAYER_FIELDS(MODAPI_FIELD_DECLARE)
+#define MODAPI_FIELD_DECLARE(object, name, luaname, type, access, ...) \
+    static MODAPI_FIELD_CTYPE(type) get##name(void); \
+    MODAPI_FIELD_DECLARE_SETTER_##access(name, type)
+#define MODAPI_FIELD_DECLARE_SETTER_rw(name, type) static void set##name(MODAPI_FIELD_CTYPE(type) value);
+#define MODAPI_FIELD_DECLARE_SETTER_ro(name, type)
+
+// Goes in the game object .cpp: MODAPI_PLAYER_FIELDS(MODAPI_FIELD_DEFINE)
+#define MODAPI_FIELD_DEFINE(object, name, luaname, type, access, ...) \
+    MODAPI_FIELD_CTYPE(type) object::get##name(void) { return FieldRegistry::read_##type(FieldId::object##_##name); } \
+    MODAPI_FIELD_DEFINE_SETTER_##access(object, name, type)
+#define MODAPI_FIELD_DEFINE_SETTER_rw(object, name, type) \
+    void object::set##name(MODAPI_FIELD_CTYPE(type) value) { FieldRegistry::write_##type(FieldId::object##_##name, value); }
+#define MODAPI_FIELD_DEFINE_SETTER_ro(object, name, type)
+
+// Goes in LuaManager::bind_api, expects a sol::usertype<object> named <object>_type in scope
+#define MODAPI_FIELD_BIND(object, name, luaname, type, access, ...) \
+    object##_type[luaname] = MODAPI_FIELD_PROPERTY_##access(object, name);
+#define MODAPI_FIELD_PROPERTY_rw(object, name) sol::property(&object::get##name, &object::set##name)
+#define MODAPI_FIELD_PROPERTY_ro(object, name) sol::readonly_property(&object::get##name)
+
+class FieldRegistry {
+    private:
+        // Every int field sharing the same root and pointer chain prefix is fetched with one ReadProcessMemory per tick
+        struct ReadGroup {
+            uintptr_t root;
+            std::vector<unsigned int> chain;
+            unsigned int begin;
+            unsigned int end;
+            size_t snapshotoffset;
+            bool valid;
+            uintptr_t base;
+        };
+        // Pinned int fields are written back right after the refresh when the game changed them, the snapshot never shows another value
+        struct Pin {
+            FieldId id;
+            int value;
+            int mod;
+        };
+        static inline uintptr_t roots[(size_t)FieldObject::Count] = {};
+        static inline std::vector<ReadGroup> plan;
+        static inline std::vector<uint8_t> snapshot;
+        static inline std::vector<size_t> slots;
+        static inline std::vector<size_t> groupof;
+        static inline std::vector<Pin> pins;
+        // Copy of the pins for the sampler thread, see tryread_int
+        static inline std::atomic<bool> pinned[(size_t)FieldId::Count] = {};
+        static inline std::atomic<int> pinnedvalues[(size_t)FieldId::Count] = {};
+        // Two copies so a publish almost never runs into a reader still copying the previous one
+        static inline SeqlockValue<FieldSnapshot> published[2];
+        static inline std::atomic<uint64_t> generation{ 0 };
+        static inline FieldSnapshot lastpublished = {};
+        static uintptr_t getaddress(FieldId id);
+        static void enforcepins(void);
+        static void publish(void);
+    public:
+        static const FieldInfo fields[(size_t)FieldId::Count];
+        static constexpr size_t npos = (size_t)-1;
+
+        static void setroot(FieldObject object, uintptr_t root);
+        static uintptr_t getroot(FieldObject object);
+        static void build(void);
+        static void refresh(void);
+        static size_t groupcount(void);
+        static bool isvalid(FieldId id);
+        static int cached(FieldId id);
+        // "player.money" -> FieldId::Player_money, FieldId::Count when there is no such field
+        static FieldId find(std::string_view name);
+        static bool pin(FieldId id, int value, int mod);
+        // Only the mod holding the pin can remove it
+        static bool unpin(FieldId id, int mod);
+        // Any thread: a consistent copy of the last published values without locking or reading the game memory,
+        // false before the first tick. Compare getgeneration() with the copy to know if it's still current.
+        static bool getpublished(FieldSnapshot& out);
+        static uint64_t getgeneration(void);
+
+        static int read_int(FieldId id);
+        // Walks the chain itself so other threads can use it, false when it's broken.
+        // A pinned field reads as its pin, what the game writes there only lasts until the next tick puts the pin back.
+        static bool tryread_int(FieldId id, int& value);
+        static void write_int(FieldId id, int value);
+        static std::string read_wstring(FieldId id);
+        static void write_wstring(FieldId id, const std::string& value);
+};
+#endif
\ No newline at end of file
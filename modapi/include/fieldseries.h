@@ -0,0 +1,77 @@
+#ifndef FIELDSERIES_H
+#define FIELDSERIES_H
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "fieldregistry.h"
+
+// The last samples of an int field taken at a fixed rate by the ChangeSampler thread, for Sample() in lua.
+// Samples go in a ring allocated once, the sum and two monotonic queues (also rings) are updated on every sample
+// so min/max/mean/rate never look at the whole window.
+// The buffers are charged to the mod that asked for them (its lua memory limit) and capped per mod,
+// lua only sees a small userdata so it doesn't know how much a series holds.
+class FieldSeries {
+    public:
+        static constexpr size_t MAX_CAPACITY = 64 * 1024;
+        static constexpr size_t MAX_MOD_MEMORY = 16 * 1024 * 1024;
+    private:
+        // Ring of sample numbers, holds at most capacity of them
+        struct Queue {
+            std::vector<uint64_t> items;
+            uint64_t head = 0;
+            uint64_t tail = 0;
+            bool empty(void) const { return head == tail; }
+            uint64_t front(void) const { return items[head % items.size()]; }
+            uint64_t back(void) const { return items[(tail - 1) % items.size()]; }
+            void popfront(void) { head++; }
+            void popback(void) { tail--; }
+            void push(uint64_t item) { items[tail++ % items.size()] = item; }
+        };
+        FieldId id;
+        int mod;
+        size_t memory;
+        int64_t interval;
+        int64_t nextsample = 0;
+        size_t capacity;
+        std::vector<int> values;
+        std::vector<int64_t> times;
+        // samples taken since the start, the window is the last min(count, capacity)
+        uint64_t count = 0;
+        int64_t sum = 0;
+        Queue minimums;
+        Queue maximums;
+        mutable std::mutex mutex;
+        static inline std::vector<std::weak_ptr<FieldSeries>> active;
+        static inline std::mutex activemutex;
+        // series memory held by each mod
+        static inline std::map<int, size_t> modmemory;
+        static inline std::mutex memorymutex;
+
+        void push(int value, int64_t time);
+        size_t getsize(void) const;
+    public:
+        // interval in microseconds, use create()
+        FieldSeries(FieldId id, int mod, int64_t interval, size_t capacity);
+        ~FieldSeries();
+        static size_t getmemory(size_t capacity);
+        // Charges the buffers to mod and starts sampling, nullptr when the mod can't hold that much more.
+        // The series is sampled until the last shared_ptr is gone
+        static std::shared_ptr<FieldSeries> create(FieldId id, int mod, int64_t interval, size_t capacity);
+        static void remove(const FieldSeries* series);
+        // Sampler thread, now in microseconds (steady clock)
+        static void sampleall(int64_t now);
+
+        size_t size(void) const;
+        std::optional<int> getlast(void) const;
+        std::optional<int> getmin(void) const;
+        std::optional<int> getmax(void) const;
+        std::optional<double> getmean(void) const;
+        // change per second between the oldest and the newest sample of the window
+        std::optional<double> getrate(void) const;
+        // oldest first
+        void getwindow(std::vector<int>& out) const;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef FILEIO_H
+#define FILEIO_H
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "eventmanager.h"
+
+enum class FileOperation { Read, Write, Append, List };
+
+// ReadFileAsync/WriteFileAsync/AppendFileAsync/ListDirectoryAsync for the mods, paths are relative to the mod folder.
+// The files are read/written by a few worker threads and the results handed to lua from the tick (dispatch),
+// either to the callback given by the mod or by resuming the coroutine that asked for them.
+// Contents go through pooled strings so loading the same data files again doesn't allocate.
+class FileIO {
+    public:
+        struct Waiter {
+            EventManager::Listener listener;
+            // set instead of the callback when a coroutine waits for the result
+            sol::thread thread;
+        };
+    private:
+        static constexpr size_t MAX_FILE_SIZE = 64 * 1024 * 1024;
+        static constexpr size_t MAX_POOLED = 8;
+        static constexpr size_t MAX_POOLED_CAPACITY = 16 * 1024 * 1024;
+        struct Job {
+            uint64_t id;
+            FileOperation operation;
+            std::string path;
+            std::string data;
+        };
+        struct Result {
+            uint64_t id;
+            bool ok;
+            std::string error;
+            std::string data;
+            std::vector<std::string> entries;
+        };
+        struct Pending {
+            FileOperation operation;
+            std::string path;
+            Waiter waiter;
+        };
+        static inline std::vector<std::thread> workers;
+        static inline std::deque<Job> jobs;
+        static inline std::deque<Result> completed;
+        static inline std::vector<std::string> buffers;
+        static inline std::mutex mutex;
+        static inline std::condition_variable wakeup;
+        static inline bool running = false;
+        // only touched by the tick
+        static inline std::map<uint64_t, Pending> pending;
+        static inline uint64_t nextid = 1;
+
+        static std::string takebuffer(void);
+        static void releasebuffer(std::string&& buffer);
+        static void run(Job& job, Result& result);
+        static void workerloop(void);
+        static int pushresult(lua_State* L, FileOperation operation, Result& result);
+    public:
+        static void start(void);
+        // Finishes the queued jobs, their results are dropped
+        static void stop(void);
+        // path inside the mod folder, false for absolute paths or paths going out of it
+        static bool getpath(int mod, const std::string& path, std::string& out);
+        static bool queue(FileOperation operation, const std::string& path, const char* data, size_t size, Waiter waiter);
+        static size_t count(void);
+        static void dispatch(void);
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef GALAXY_H
+#define GALAXY_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Catalog of every system and station, walked out of the game tables once and kept as structure of arrays
+// with a k-d tree over the map coordinates and a tech level index for the lookups the mods do.
+// The table locations come from modapi.cfg (galaxy.systems.* / galaxy.stations.*), the element layouts from the
+// System/Station schema. Without configured tables the catalog fills itself with the systems/stations the player visits.
+class Galaxy {
+    public:
+        struct SystemInfo {
+            int id;
+            int risk;
+            int faction;
+            int x;
+            int y;
+            int z;
+            int jumpgatestationid;
+        };
+        struct StationInfo {
+            int id;
+            int techlevel;
+            std::string name;
+        };
+    private:
+        struct Table {
+            std::vector<unsigned int> array;
+            std::vector<unsigned int> count;
+            unsigned int stride;
+            bool indirect;
+            uintptr_t base;
+            int size;
+        };
+        static inline struct {
+            std::vector<int> id;
+            std::vector<int> risk;
+            std::vector<int> faction;
+            std::vector<int> x;
+            std::vector<int> y;
+            std::vector<int> z;
+            std::vector<int> jumpgatestationid;
+        } systems;
+        static inline struct {
+            std::vector<int> id;
+            std::vector<int> techlevel;
+            std::vector<std::string> name;
+        } stations;
+        // system indices laid out as an implicit k-d tree (median of each range is the node, split axis = depth % 3)
+        static inline std::vector<uint32_t> kdtree;
+        static inline std::vector<uint32_t> bytechlevel;
+        static inline Table systemtable = {};
+        static inline Table stationtable = {};
+        static inline uintptr_t modulebase = 0;
+
+        static uintptr_t resolve(const std::vector<unsigned int>& chain);
+        static bool loadtable(const std::string& name, Table& table);
+        static bool locate(Table& table, uintptr_t& base, int& size);
+        static uintptr_t getelement(const Table& table, uintptr_t base, int index);
+        static void readsystems(void);
+        static void readstations(void);
+        static void addsystem(const SystemInfo& info);
+        static void addstation(const StationInfo& info);
+        // Records the current system and station, that's how the catalog fills up without configured tables
+        static void observe(void);
+        static void buildkdtree(size_t begin, size_t end, int depth);
+        static void buildindexes(void);
+        static int64_t getdistance(uint32_t index, int x, int y, int z);
+        static void searchnearest(size_t begin, size_t end, int depth, int x, int y, int z, size_t count, std::vector<std::pair<int64_t, uint32_t>>& heap);
+        static void searchradius(size_t begin, size_t end, int depth, int x, int y, int z, int64_t radius, std::vector<uint32_t>& out);
+    public:
+        static void init(void);
+        // Cheap per tick check (needs the FieldRegistry snapshot), the catalog is only rebuilt when a table moved or changed size
+        static void refresh(void);
+
+        static size_t systemcount(void);
+        static size_t stationcount(void);
+        static SystemInfo getsystem(uint32_t index);
+        static StationInfo getstation(uint32_t index);
+        static bool findsystem(int id, uint32_t& index);
+        // Indices of the closest systems, closest first
+        static void nearest(int x, int y, int z, size_t count, std::vector<uint32_t>& out);
+        static void withinradius(int x, int y, int z, int64_t radius, std::vector<uint32_t>& out);
+        static void stationsbytechlevel(int min, int max, std::vector<uint32_t>& out);
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef GAMEPHASE_H
+#define GAMEPHASE_H
+#include <cstdint>
+#include <vector>
+
+enum class Phase { Loading, MainMenu, InSpace, Docked };
+
+// Where the player is, worked out once per tick from the FieldRegistry snapshot.
+// A new phase has to be seen for a few ticks in a row before it's taken, the pointers hold garbage while the game sets them up.
+// The in game / docked signals come from probes in modapi.cfg (phase.ingame_probe / phase.docked_probe, non zero int = true).
+// Without them the phase is guessed from the mission id and the station pointer like the first IsInGame event did,
+// which keeps saying in game after going back to the menu (the mission id isn't cleared). phase.heuristic = false turns the guess off.
+class GamePhase {
+    private:
+        static constexpr int STABLE_TICKS = 3;
+        static inline Phase current = Phase::Loading;
+        static inline Phase candidate = Phase::Loading;
+        static inline int stableticks = 0;
+        static inline std::vector<unsigned int> ingameprobe;
+        static inline std::vector<unsigned int> dockedprobe;
+        static inline uintptr_t modulebase = 0;
+        static inline bool heuristic = true;
+        static bool probe(const std::vector<unsigned int>& chain, bool& value);
+        static Phase detect(void);
+    public:
+        static void init(void);
+        // Returns true when the phase changed this tick, previous gets the phase it left
+        static bool update(Phase& previous);
+        static Phase get(void);
+        static const char* getname(Phase phase);
+        static bool isingame(Phase phase);
+};
+#endif
\ No newline at end of file
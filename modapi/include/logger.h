@@ -0,0 +1,88 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <string>
+#include <string_view>
+#include <thread>
+
+enum class LogLevel { Debug, Info, Warning, Error };
+
+// Lines are pushed into a bounded lock free ring and written to the console/log file by a background thread,
+// so logging from the tick never waits on the console. When the ring is full the line is dropped and counted.
+class Logger {
+    private:
+        static constexpr size_t SLOT_COUNT = 1024;
+        static constexpr size_t TAG_SIZE = 32;
+        static constexpr size_t TEXT_SIZE = 480;
+        struct Slot {
+            std::atomic<size_t> sequence;
+            LogLevel level;
+            uint16_t length;
+            char tag[TAG_SIZE];
+            char text[TEXT_SIZE];
+        };
+        static Slot slots[SLOT_COUNT];
+        static inline std::atomic<size_t> head = 0;
+        static inline size_t tail = 0;
+        static inline std::atomic<uint64_t> dropped = 0;
+        static inline std::atomic<int> minlevel = (int)LogLevel::Info;
+        static inline std::atomic<bool> running = false;
+        static inline std::thread writer;
+        static inline FILE* logfile = nullptr;
+        // false when the game has no console, lines then only go to the log file
+        static inline bool console = true;
+        static inline std::string logpath;
+        static inline size_t logsize = 0;
+        static inline size_t maxlogsize = 0;
+        static inline int maxlogfiles = 0;
+
+        static void writerloop(void);
+        static bool drain(void);
+        static void output(const Slot& slot);
+        static void rotate(void);
+    public:
+        static void start(void);
+        static void stop(void);
+        static void setlevel(LogLevel level);
+        static LogLevel parselevel(const std::string& name, LogLevel fallback);
+        static bool enabled(LogLevel level);
+        static void setfile(const std::string& filepath, size_t maxsize, int maxfiles);
+        static void setconsole(bool enabled);
+        static void write(LogLevel level, std::string_view tag, std::string_view text);
+        static uint64_t getdropped(void);
+
+        template <typename... Args>
+        static void log(LogLevel level, std::string_view tag, std::format_string<Args...> fmt, Args&&... args)
+        {
+            if (!enabled(level))
+                return;
+
+            char buffer[TEXT_SIZE];
+            auto result = std::format_to_n(buffer, sizeof(buffer), fmt, std::forward<Args>(args)...);
+            write(level, tag, std::string_view(buffer, result.out - buffer));
+        }
+        template <typename... Args>
+        static void debug(std::string_view tag, std::format_string<Args...> fmt, Args&&... args)
+        {
+            log(LogLevel::Debug, tag, fmt, std::forward<Args>(args)...);
+        }
+        template <typename... Args>
+        static void info(std::string_view tag, std::format_string<Args...> fmt, Args&&... args)
+        {
+            log(LogLevel::Info, tag, fmt, std::forward<Args>(args)...);
+        }
+        template <typename... Args>
+        static void warning(std::string_view tag, std::format_string<Args...> fmt, Args&&... args)
+        {
+            log(LogLevel::Warning, tag, fmt, std::forward<Args>(args)...);
+        }
+        template <typename... Args>
+        static void error(std::string_view tag, std::format_string<Args...> fmt, Args&&... args)
+        {
+            log(LogLevel::Error, tag, fmt, std::forward<Args>(args)...);
+        }
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef LUAALLOCATOR_H
+#define LUAALLOCATOR_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// lua_Alloc for the mods lua state.
+// Small blocks come from 16KB slab pages carved out of 1MB arenas, every page only holds blocks of one size class for one mod
+// so a free knows who to credit just from the page header, bigger blocks go to malloc with a small header.
+// Usage is accounted per mod (ModContext id) and a mod going over its limit gets a lua "not enough memory" error.
+class LuaAllocator {
+    public:
+        static constexpr size_t MAX_MODS = 256;
+        static constexpr size_t PAGE_SIZE = 16 * 1024;
+        static constexpr size_t ARENA_SIZE = 1024 * 1024;
+        static constexpr size_t MAX_SMALL = 256;
+        static constexpr size_t GRANULARITY = 16;
+        static constexpr size_t CLASS_COUNT = MAX_SMALL / GRANULARITY;
+
+        struct Stats {
+            std::atomic<size_t> used;
+            std::atomic<size_t> peak;
+            std::atomic<size_t> limit;
+            std::atomic<uint64_t> allocations;
+            std::atomic<uint64_t> failures;
+        };
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+        struct alignas(16) Page {
+            Page* prev;
+            Page* next;
+            FreeBlock* freelist;
+            uint8_t* bump;
+            uint16_t owner;
+            uint16_t sizeclass;
+            uint16_t live;
+            uint16_t capacity;
+        };
+        struct alignas(16) LargeHeader {
+            // links of the demoted list
+            LargeHeader* prev;
+            LargeHeader* next;
+            uint32_t owner;
+        };
+        static inline Page* partial[MAX_MODS][CLASS_COUNT] = {};
+        static inline Page* freepages = nullptr;
+        static inline uint8_t* arenacursor = nullptr;
+        static inline uint8_t* arenaend = nullptr;
+        static inline std::atomic<size_t> reserved = 0;
+        // large blocks kept in place by a failed shrink to a small size, lua now frees them with a small size
+        static inline LargeHeader* demoted = nullptr;
+        static Stats stats[MAX_MODS];
+
+        static size_t getowner(void);
+        static Page* newpage(size_t owner, size_t sizeclass);
+        static void* allocsmall(size_t owner, size_t size);
+        static void freesmall(void* ptr);
+        static void* alloclarge(size_t owner, size_t size);
+        static void freelarge(void* ptr);
+        static bool isdemoted(void* ptr);
+        static bool reserve(size_t owner, size_t size);
+        static void release(size_t owner, size_t size);
+    public:
+        static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+        static void setlimit(int mod, size_t bytes);
+        // Memory a mod holds outside of lua (Sample buffers), counted and limited like its lua memory
+        static bool charge(int mod, size_t bytes);
+        static void uncharge(int mod, size_t bytes);
+        static const Stats& getstats(int mod);
+        static size_t getreserved(void);
+};
+#endif
\ No newline at end of file
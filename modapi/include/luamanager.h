@@ -10,10 +10,27 @@
 #include <sol/sol.hpp>
 #include <map>
 #include <string>
+#include <chrono>
 #include "modapi_utils.h"
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -22,8 +39,22 @@
 
 class LuaManager {
     private:
-        sol::state lua_state;
+        sol::state lua_state{ sol::default_at_panic, &LuaAllocator::alloc };
+        // the automatic collector is stopped, the tick drives it through collectgarbage()
+        static inline bool fullgcrequested = false;
+        int gcstepkb = 16;
+        std::chrono::microseconds gcbudget{ 2000 };
+        size_t gcbaseline = 0;
+        struct {
+            int64_t lastpause;
+            int64_t maxpause;
+            int64_t lastfullpause;
+            uint64_t steps;
+            uint64_t fullcollections;
+        } gcstats = {};
     public:
+        static void requestfullgc(void);
+        void collectgarbage(std::chrono::steady_clock::time_point deadline);
         void init(void);
         void bind_api(void);
         void execute_script(const std::string& filepath);
@@ -0,0 +1,71 @@
+#ifndef MEMORYBUFFER_H
+#define MEMORYBUFFER_H
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum class BufferType { U8, I8, U16, I16, U32, I32, F32, F64, Ptr, UTF16, String };
+
+// Copy of a range of game memory taken with one ReadProcessMemory, the lua side then picks values out of it
+// instead of doing one call per value. Copies come from power of two blocks kept in free lists,
+// so reading the same table every tick doesn't allocate once the lists are warm.
+class MemoryBuffer {
+    public:
+        static constexpr size_t MIN_SIZE = 256;
+        static constexpr size_t MAX_SIZE = 1024 * 1024;
+        // A named value at an offset of a struct, length is in characters for UTF16/String
+        struct Field {
+            std::string name;
+            BufferType type;
+            size_t offset;
+            size_t length;
+        };
+        struct Layout {
+            std::vector<Field> fields;
+        };
+    private:
+        // 256 B, 512 B, ... 1 MB
+        static constexpr size_t CLASS_COUNT = 13;
+        // blocks kept per class, the others go back to the heap
+        static constexpr size_t MAX_FREE = 8;
+        static inline std::vector<uint8_t*> freeblocks[CLASS_COUNT];
+        static inline uintptr_t modulebase = 0;
+        uint8_t* data = nullptr;
+        size_t size = 0;
+
+        static size_t getclass(size_t size);
+        static uint8_t* allocate(size_t size);
+        static void release(uint8_t* block, size_t size);
+    public:
+        MemoryBuffer() = default;
+        ~MemoryBuffer();
+        MemoryBuffer(const MemoryBuffer&) = delete;
+        MemoryBuffer& operator=(const MemoryBuffer&) = delete;
+
+        // First offset is relative to GoF2.exe like the config chains, the others are followed like the schema chains
+        static uintptr_t resolve(const std::vector<unsigned int>& chain);
+        static bool parsetype(const std::string& name, BufferType& type);
+        // 0 for UTF16/String, their size depends on the length
+        static size_t gettypesize(BufferType type);
+
+        // False when size is 0 or above MAX_SIZE or part of the range can't be read
+        bool read(uintptr_t address, size_t size);
+        // Gives the block back before the lua collector gets to the buffer
+        void free(void);
+        size_t getsize(void) const;
+
+        // All the getters return false when the value doesn't fit in the buffer
+        template <typename T>
+        bool get(size_t offset, T& value) const
+        {
+            if (!data || offset > size || sizeof(T) > size - offset)
+                return false;
+            memcpy(&value, data + offset, sizeof(T));
+            return true;
+        }
+        // UTF-16 / single byte text of at most length characters, stops at the first 0
+        bool getutf16(size_t offset, size_t length, std::string& out) const;
+        bool getstring(size_t offset, size_t length, std::string& out) const;
+};
+#endif
\ No newline at end of file
@@ -14,6 +14,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -21,8 +37,12 @@
 #include <Game/asset.h>
 
 class MemoryUtils {
+    private:
+        static inline std::map<std::string, uintptr_t> modulebases;
     public:
         static uintptr_t GetModuleBase(const char* modulename);
+        // GetModuleBase returns base for this module from now on, the headless runner points GoF2.exe at its fake memory with it
+        static void OverrideModuleBase(const char* modulename, uintptr_t base);
         static uintptr_t GetPointerAddress(uintptr_t baseaddr, const std::vector<unsigned int>& offsets);
         static std::wstring ReadRawString(uintptr_t address, size_t size = 256)
         {
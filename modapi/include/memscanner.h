@@ -0,0 +1,99 @@
+#ifndef MEMSCANNER_H
+#define MEMSCANNER_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class ScanType { Int, Float, String, WString };
+enum class ScanCompare { Exact, Range, Changed, Unchanged, Increased, Decreased };
+
+// Cheat table style value search over the readable memory of the process, the first scan looks at every region
+// and the next ones only re check what the previous scan kept.
+// Regions are cut in blocks scanned by one thread each, ints/floats are 4 byte aligned and compared 4 at a time with SSE2.
+// Results are kept per block as 32 bit offsets (plus the 32 bit value seen for ints/floats).
+// Everything the scanner allocates comes from its own pages that are left out of the scans,
+// otherwise it would find the values it just copied. Doesn't use any game/lua code so it also runs on Linux.
+class MemoryScanner {
+    public:
+        struct Region {
+            uintptr_t base;
+            size_t size;
+        };
+        static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+        static constexpr size_t MAX_RESULTS = 8 * 1024 * 1024;
+
+        // Memory from pages the scanner owns, tracked so getregions can skip them
+        template <typename T>
+        struct Allocator {
+            using value_type = T;
+            Allocator() = default;
+            template <typename U>
+            Allocator(const Allocator<U>&) {}
+            T* allocate(size_t count) { return (T*)allocatememory(count * sizeof(T)); }
+            void deallocate(T* pointer, size_t count) { freememory(pointer, count * sizeof(T)); }
+            template <typename U>
+            bool operator==(const Allocator<U>&) const { return true; }
+            template <typename U>
+            bool operator!=(const Allocator<U>&) const { return false; }
+        };
+        template <typename T>
+        using Vector = std::vector<T, Allocator<T>>;
+    private:
+        struct Block {
+            uintptr_t base;
+            size_t size;
+            // end of the region, a string match can run past the block
+            uintptr_t limit;
+            Vector<uint32_t> offsets;
+            Vector<uint32_t> values;
+        };
+        ScanType type;
+        Vector<uint8_t> pattern;
+        std::vector<Block> blocks;
+        std::atomic<size_t> results{ 0 };
+        std::atomic<bool> truncated{ false };
+        bool scanned = false;
+        std::thread worker;
+        std::atomic<bool> finished{ false };
+        std::function<void(size_t)> oncomplete;
+        static inline std::vector<MemoryScanner*> pending;
+
+        static void* allocatememory(size_t size);
+        static void freememory(void* pointer, size_t size);
+        static bool readmemory(uintptr_t address, void* buffer, size_t size);
+        static void parallelfor(size_t count, const std::function<void(size_t)>& job);
+        bool setpattern(const std::string& text);
+        bool addresult(Block& block, size_t offset, uint32_t value);
+        void firstblock(Block& block, ScanCompare compare, uint32_t a, uint32_t b);
+        void nextblock(Block& block, ScanCompare compare, uint32_t a, uint32_t b);
+        bool getbounds(double a, double b, uint32_t& rawa, uint32_t& rawb);
+        size_t compactblocks(void);
+    public:
+        MemoryScanner(ScanType type);
+        // Waits for a scan still running
+        ~MemoryScanner();
+        MemoryScanner(const MemoryScanner&) = delete;
+        MemoryScanner& operator=(const MemoryScanner&) = delete;
+
+        static void getregions(std::vector<Region>& out);
+        static bool parsetype(const std::string& name, ScanType& type);
+        static bool parsecompare(const std::string& name, ScanCompare& compare);
+
+        // Numeric scans use a (and b for Range), string scans use text. Return false when the compare doesn't fit the type.
+        bool first(ScanCompare compare, double a, double b, const std::string& text);
+        bool next(ScanCompare compare, double a, double b, const std::string& text);
+        // Runs first/next on a worker thread, oncomplete gets the result count from dispatch()
+        bool start(std::function<bool(MemoryScanner&)> scan, std::function<void(size_t)> oncomplete);
+        bool isbusy(void);
+        static void dispatch(void);
+
+        size_t count(void);
+        bool istruncated(void);
+        void getresults(std::vector<uintptr_t>& out, size_t max);
+        void reset(void);
+};
+#endif
\ No newline at end of file
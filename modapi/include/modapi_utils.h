@@ -10,10 +10,27 @@
 #include <sol/sol.hpp>
 #include <map>
 #include <string>
+#include <chrono>
 #include "modapi_utils.h"
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -25,6 +42,8 @@ class ModApiUtils {
         DWORD getmainthreadid(void);
     public:
         void suspendgame(bool suspend);
-        static void load_mods(LuaManager *luamanager);
+        static void load_mods(LuaManager *luamanager, const std::string& mods_folder = "mods");
+        // One tick of the modapi: events, then lua garbage collection until deadline
+        static void run_tick(LuaManager *luamanager, std::chrono::steady_clock::time_point deadline);
 };
 #endif
\ No newline at end of file
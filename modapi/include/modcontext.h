@@ -0,0 +1,34 @@
+#ifndef MODCONTEXT_H
+#define MODCONTEXT_H
+#include <vector>
+#include <string>
+
+// Keeps track of the loaded mods and of the one whose lua code is currently running on the mod thread
+// Id 0 is the modapi itself (anything running outside of a mod script or callback)
+class ModContext {
+    private:
+        struct Mod {
+            std::string name;
+            std::string path;
+        };
+        static inline std::vector<Mod> mods = { { "modapi", "" } };
+        static inline int current = 0;
+    public:
+        class Scope {
+            private:
+                int previous;
+            public:
+                Scope(int id);
+                ~Scope();
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+        };
+
+        static int registermod(const std::string& name, const std::string& path);
+        static int getcurrent(void);
+        static void setcurrent(int id);
+        static const std::string& getname(int id);
+        static const std::string& getpath(int id);
+        static size_t count(void);
+};
+#endif
\ No newline at end of file
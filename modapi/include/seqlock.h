@@ -0,0 +1,67 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Sequence lock: one writer at a time bumps the sequence to odd, writes, then bumps it back to even.
+// Readers never block the writer, they copy the data and retry if the sequence moved meanwhile.
+class Seqlock {
+    private:
+        std::atomic<uint32_t> sequence = 0;
+    public:
+        uint32_t readbegin(void) const
+        {
+            uint32_t start;
+
+            while ((start = sequence.load(std::memory_order_acquire)) & 1)
+                ;
+            return start;
+        }
+        bool readretry(uint32_t start) const
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return sequence.load(std::memory_order_relaxed) != start;
+        }
+        void writebegin(void)
+        {
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        void writeend(void)
+        {
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+        uint32_t getsequence(void) const
+        {
+            return sequence.load(std::memory_order_acquire);
+        }
+};
+
+template <typename T>
+class SeqlockValue {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqlockValue needs a trivially copyable type");
+    private:
+        Seqlock lock;
+        T value{};
+    public:
+        void store(const T& newvalue)
+        {
+            lock.writebegin();
+            memcpy((void*)&value, &newvalue, sizeof(T));
+            lock.writeend();
+        }
+        T load(void) const
+        {
+            T copy;
+            uint32_t start;
+
+            do {
+                start = lock.readbegin();
+                memcpy((void*)&copy, (const void*)&value, sizeof(T));
+            } while (lock.readretry(start));
+            return copy;
+        }
+};
+#endif
\ No newline at end of file
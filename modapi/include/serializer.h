@@ -0,0 +1,21 @@
+#ifndef SERIALIZER_H
+#define SERIALIZER_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sol/sol.hpp>
+
+// Compact binary encoding of plain lua values (nil, booleans, numbers, strings and tables of those).
+// One tag byte per value, integers are zigzag varints, strings and tables are prefixed with a varint length/count.
+class Serializer {
+    public:
+        static constexpr int MAX_DEPTH = 16;
+
+        // Appends the value at the given stack index to out, returns false (with error set) for values that can't be stored
+        static bool encode(lua_State* L, int index, std::string& out, std::string& error, int depth = 0);
+        // Pushes the decoded value, returns false (pushing nothing) when the data is truncated or corrupt
+        static bool decode(lua_State* L, const uint8_t*& data, const uint8_t* end, int depth = 0);
+        static void writevarint(std::string& out, uint64_t value);
+        static bool readvarint(const uint8_t*& data, const uint8_t* end, uint64_t& value);
+};
+#endif
\ No newline at end of file
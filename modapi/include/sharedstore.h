@@ -0,0 +1,57 @@
+#ifndef SHAREDSTORE_H
+#define SHAREDSTORE_H
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include "seqlock.h"
+#include "eventmanager.h"
+
+// Key/value store owned by the modapi so mods can share data without touching each other's globals.
+// Values are kept serialized (see Serializer) in a fixed open addressing table: slots are never moved or freed,
+// so readers find a key and copy its value under the slot seqlock without taking any lock.
+// Writers are serialized by a mutex and queue the changed slots for the subscribers, notified from the tick.
+class SharedStore {
+    public:
+        static constexpr size_t CAPACITY = 1024;
+        static constexpr size_t KEY_SIZE = 64;
+        static constexpr size_t VALUE_SIZE = 512;
+    private:
+        struct Slot {
+            std::atomic<bool> used;
+            uint32_t hash;
+            uint8_t keylength;
+            char key[KEY_SIZE];
+            Seqlock lock;
+            std::atomic<uint32_t> version;
+            std::atomic<bool> pending;
+            uint32_t size;
+            uint8_t data[VALUE_SIZE];
+        };
+        static Slot slots[CAPACITY];
+        static inline std::mutex writelock;
+        static inline std::vector<uint32_t> changed;
+        static inline std::map<std::string, std::vector<EventManager::Listener>, std::less<>> subscribers;
+        // subscriptions made by a callback while dispatch walks the subscribers, added once it's done
+        static inline bool dispatching = false;
+        static inline std::vector<std::pair<std::string, EventManager::Listener>> deferred;
+
+        static uint32_t gethash(std::string_view key);
+        static Slot* find(std::string_view key);
+    public:
+        // Both return false when the key is too long, the value too big or the store is full
+        static bool set(std::string_view key, const uint8_t* data, size_t size);
+        // Copies the value, returns false when the key was never set
+        static bool get(std::string_view key, std::vector<uint8_t>& out, uint32_t* version = nullptr);
+        static uint32_t getversion(std::string_view key);
+        // Hands every key changed since the last call (once even if it changed several times)
+        static void takechanged(std::vector<std::string>& keys);
+
+        static void subscribe(const std::string& key, sol::protected_function callback);
+        // Calls the subscribers of every key changed since the last tick with (value, key)
+        static void dispatch(void);
+};
+#endif
\ No newline at end of file
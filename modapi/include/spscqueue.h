@@ -0,0 +1,43 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock free queue for exactly one producer thread and one consumer thread.
+// Head and tail sit on their own cache lines so the two threads don't fight over them.
+template <typename T, size_t CAPACITY>
+class SpscQueue {
+    private:
+        static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+        alignas(64) std::atomic<size_t> head{ 0 };
+        alignas(64) std::atomic<size_t> tail{ 0 };
+        alignas(64) T items[CAPACITY];
+    public:
+        // Producer only, false when the queue is full
+        bool push(const T& item)
+        {
+            size_t position = head.load(std::memory_order_relaxed);
+
+            if (position - tail.load(std::memory_order_acquire) == CAPACITY)
+                return false;
+            items[position & (CAPACITY - 1)] = item;
+            head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+        // Consumer only, false when the queue is empty
+        bool pop(T& item)
+        {
+            size_t position = tail.load(std::memory_order_relaxed);
+
+            if (position == head.load(std::memory_order_acquire))
+                return false;
+            item = items[position & (CAPACITY - 1)];
+            tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+        size_t size(void) const
+        {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Persistent key/value storage of each mod, values are kept serialized (see Serializer).
+// The file (storage.dat in the mod folder) is a journal: a magic followed by one record per write,
+// record = u32 body size, u32 FNV-1a of the body, body = varint key size, key, u8 op (1 set, 0 remove), value.
+// It's only read (memory mapped) the first time the mod touches its storage, after that every write updates
+// the in memory copy and queues its record for the writer thread, so the tick never waits on the disk.
+// Once the journal is mostly dead records the live ones are rewritten into a fresh file, the tick only hands the value handles
+// to the writer thread which builds the records.
+class Storage {
+    private:
+        static constexpr uint32_t MAGIC = 0x31534D4B; // "KMS1"
+        static constexpr size_t HEADER_SIZE = 2 * sizeof(uint32_t);
+        static constexpr size_t COMPACT_MIN_SIZE = 64 * 1024;
+        struct Store {
+            bool loaded;
+            std::string path;
+            // shared with the compactions still queued, a value is replaced and never changed in place
+            std::map<std::string, std::shared_ptr<const std::string>> values;
+            size_t livesize;
+            size_t journalsize;
+        };
+        struct Job {
+            std::string path;
+            std::string data;
+            bool replace;
+            // for a compaction: the live values, written as records after the magic instead of data
+            std::vector<std::pair<std::string, std::shared_ptr<const std::string>>> values;
+        };
+        static inline std::vector<Store> stores;
+        static inline size_t maxsize = 4096 * 1024;
+        static inline std::deque<Job> jobs;
+        static inline std::mutex mutex;
+        static inline std::condition_variable wakeup;
+        static inline std::thread writer;
+        static inline bool running = false;
+        static inline bool persistent = true;
+
+        static uint32_t gethash(const char* data, size_t size);
+        static void writerecord(std::string& out, const std::string& key, const std::string* value);
+        static size_t getrecordsize(const std::string& key, const std::string& value);
+        static Store& getstore(int mod);
+        static void load(Store& store);
+        static void queue(Job job);
+        static void compact(Store& store);
+        static void writerloop(void);
+    public:
+        static void start(void);
+        // false keeps every write in memory, for the headless runner: the files are still read but never written
+        static void setpersistent(bool enabled);
+        // Flushes every queued write before returning
+        static void stop(void);
+        static bool set(int mod, const std::string& key, const std::string& value);
+        static bool remove(int mod, const std::string& key);
+        static const std::string* get(int mod, const std::string& key);
+        static void getkeys(int mod, std::vector<std::string>& out);
+};
+#endif
\ No newline at end of file
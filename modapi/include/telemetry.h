@@ -0,0 +1,21 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "telemetrylayout.h"
+
+// Publishes the FieldRegistry snapshot to external tools through shared memory (layout in telemetrylayout.h).
+// Off unless telemetry.enabled is set in modapi.cfg, publishing is a copy of the snapshot into the next slot, it never waits on a reader.
+class Telemetry {
+    private:
+        static inline SharedMemory memory;
+        static inline TelemetryBuffer* buffer = nullptr;
+    public:
+        static void start(void);
+        static void stop(void);
+        static void publish(void);
+        // Hands every command the tools sent since the last call
+        static void takecommands(std::vector<std::string>& out);
+};
+#endif
\ No newline at end of file
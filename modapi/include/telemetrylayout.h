@@ -0,0 +1,302 @@
+#ifndef TELEMETRYLAYOUT_H
+#define TELEMETRYLAYOUT_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "seqlock.h"
+
+// Layout of the telemetry shared memory, shared by the modapi (writer) and the external tools (readers).
+// Every tick the modapi writes a snapshot of the schema fields into the next slot of a ring, each slot has its own seqlock
+// so a reader looks at the newest slot in place and only has to retry if the writer lapped it meanwhile.
+// Tools send commands back through a small bounded MPMC ring (same algorithm as the logger), they reach lua as OnTelemetryCommand.
+// Everything is fixed size and made of 32/64 bit integers so a 64 bit reader sees the same layout as the 32 bit game.
+
+#define TELEMETRY_NAME "KaamoClubModApiTelemetry"
+
+static constexpr uint32_t TELEMETRY_MAGIC = 0x544D434B; // "KCMT"
+// Bumped whenever the layout below changes
+static constexpr uint32_t TELEMETRY_VERSION = 2;
+static constexpr uint32_t TELEMETRY_MAX_FIELDS = 64;
+static constexpr uint32_t TELEMETRY_MAX_STRINGS = 8;
+static constexpr uint32_t TELEMETRY_STRING_SIZE = 64;
+static constexpr uint32_t TELEMETRY_SLOTS = 16;
+static constexpr uint32_t TELEMETRY_COMMAND_SLOTS = 32;
+static constexpr uint32_t TELEMETRY_COMMAND_SIZE = 248;
+
+enum TelemetryFieldType : uint32_t { TELEMETRY_INT = 0, TELEMETRY_STRING = 1 };
+
+struct TelemetryField {
+    char object[16];
+    char name[32];
+    uint32_t type;
+    // into ints[] or strings[] of the snapshot
+    uint32_t index;
+};
+
+struct TelemetrySnapshot {
+    uint32_t tick;
+    // Phase of gamephase.h
+    uint32_t phase;
+    // microseconds, steady clock of the writer
+    int64_t timestamp;
+    // bit n set when field n could be read this tick
+    uint64_t validmask;
+    int32_t ints[TELEMETRY_MAX_FIELDS];
+    // UTF-8, zero terminated
+    char strings[TELEMETRY_MAX_STRINGS][TELEMETRY_STRING_SIZE];
+};
+
+struct alignas(64) TelemetrySlot {
+    Seqlock lock;
+    TelemetrySnapshot snapshot;
+};
+
+struct TelemetryCommand {
+    std::atomic<uint32_t> sequence;
+    uint32_t size;
+    char text[TELEMETRY_COMMAND_SIZE];
+};
+
+struct TelemetryBuffer {
+    // written last by the creator, readers wait for it
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t fieldcount;
+    uint32_t slotcount;
+    // snapshots published so far, the newest one is slots[(published - 1) % slotcount]
+    std::atomic<uint32_t> published;
+    std::atomic<uint32_t> commandhead;
+    std::atomic<uint32_t> commandtail;
+    // process id of the writer, a new writer only takes the buffer over once that process is gone
+    uint32_t writer;
+    TelemetryField fields[TELEMETRY_MAX_FIELDS];
+    TelemetrySlot slots[TELEMETRY_SLOTS];
+    TelemetryCommand commands[TELEMETRY_COMMAND_SLOTS];
+
+    // Sets up an empty buffer, only the creator calls it.
+    // The memory may still hold the buffer of a writer that crashed (a reader kept it open), so every field is reset.
+    void init(uint32_t writerpid)
+    {
+        magic.store(0, std::memory_order_relaxed);
+        version = TELEMETRY_VERSION;
+        fieldcount = 0;
+        slotcount = TELEMETRY_SLOTS;
+        published.store(0, std::memory_order_relaxed);
+        commandhead.store(0, std::memory_order_relaxed);
+        commandtail.store(0, std::memory_order_relaxed);
+        writer = writerpid;
+        memset(fields, 0, sizeof(fields));
+        for (uint32_t i = 0; i < TELEMETRY_SLOTS; i++) {
+            // a writer that died inside a publish left the sequence odd, readers would wait on it forever
+            if (slots[i].lock.getsequence() & 1)
+                slots[i].lock.writeend();
+            memset(&slots[i].snapshot, 0, sizeof(TelemetrySnapshot));
+        }
+        for (uint32_t i = 0; i < TELEMETRY_COMMAND_SLOTS; i++) {
+            commands[i].sequence.store(i, std::memory_order_relaxed);
+            commands[i].size = 0;
+        }
+    }
+    bool isready(void) const
+    {
+        return magic.load(std::memory_order_acquire) == TELEMETRY_MAGIC && version == TELEMETRY_VERSION;
+    }
+    TelemetrySnapshot& beginpublish(void)
+    {
+        TelemetrySlot& slot = slots[published.load(std::memory_order_relaxed) % slotcount];
+
+        slot.lock.writebegin();
+        return slot.snapshot;
+    }
+    void endpublish(void)
+    {
+        uint32_t count = published.load(std::memory_order_relaxed);
+
+        slots[count % slotcount].lock.writeend();
+        published.store(count + 1, std::memory_order_release);
+    }
+    // Calls visit on the newest snapshot in place (visit must only read it), false when nothing was published yet.
+    // visit runs again when the writer reused the slot while it was reading.
+    template <typename F>
+    bool readlatest(F&& visit) const
+    {
+        for (;;) {
+            uint32_t count = published.load(std::memory_order_acquire);
+            if (count == 0)
+                return false;
+            const TelemetrySlot& slot = slots[(count - 1) % slotcount];
+            uint32_t start = slot.lock.readbegin();
+            visit(slot.snapshot);
+            if (!slot.lock.readretry(start))
+                return true;
+        }
+    }
+    // Any process can push, false when the ring is full or the text too long
+    bool pushcommand(const char* text, size_t size)
+    {
+        uint32_t position = commandhead.load(std::memory_order_relaxed);
+
+        if (size > TELEMETRY_COMMAND_SIZE)
+            return false;
+        for (;;) {
+            TelemetryCommand& command = commands[position % TELEMETRY_COMMAND_SLOTS];
+            int32_t diff = (int32_t)(command.sequence.load(std::memory_order_acquire) - position);
+            if (diff == 0) {
+                if (commandhead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    command.size = (uint32_t)size;
+                    memcpy(command.text, text, size);
+                    command.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = commandhead.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    // Only the modapi pops, text must hold TELEMETRY_COMMAND_SIZE bytes.
+    // Any process can write this memory, so the size is read once and clamped, the slot is released either way.
+    bool popcommand(char* text, size_t& size)
+    {
+        uint32_t position = commandtail.load(std::memory_order_relaxed);
+        TelemetryCommand& command = commands[position % TELEMETRY_COMMAND_SLOTS];
+
+        if ((int32_t)(command.sequence.load(std::memory_order_acquire) - (position + 1)) < 0)
+            return false;
+        uint32_t length = *(volatile uint32_t*)&command.size;
+        size = length < TELEMETRY_COMMAND_SIZE ? length : TELEMETRY_COMMAND_SIZE;
+        memcpy(text, command.text, size);
+        command.sequence.store(position + TELEMETRY_COMMAND_SLOTS, std::memory_order_release);
+        commandtail.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+// Process id stored in TelemetryBuffer::writer
+inline uint32_t telemetryprocess(void)
+{
+#ifdef _WIN32
+    return (uint32_t)GetCurrentProcessId();
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+// Whether the writer recorded in a buffer is still running
+inline bool telemetryprocessalive(uint32_t pid)
+{
+    if (pid == 0)
+        return false;
+#ifdef _WIN32
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    if (!process)
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+#else
+    return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+#endif
+}
+
+// Named shared memory: a file mapping on Windows, a POSIX shm object elsewhere
+class SharedMemory {
+    private:
+#ifdef _WIN32
+        HANDLE handle = NULL;
+#else
+        int fd = -1;
+        bool owner = false;
+        char name[64] = {};
+#endif
+        void* view = nullptr;
+        size_t size = 0;
+        bool existing = false;
+    public:
+        bool open(const char* objectname, size_t viewsize, bool create)
+        {
+            size = viewsize;
+#ifdef _WIN32
+            char fullname[128];
+            snprintf(fullname, sizeof(fullname), "Local\\%s", objectname);
+            if (create) {
+                handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, fullname);
+                existing = handle && GetLastError() == ERROR_ALREADY_EXISTS;
+            } else
+                handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, fullname);
+            if (!handle)
+                return false;
+            view = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#else
+            snprintf(name, sizeof(name), "/%s", objectname);
+            fd = create ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600) : -1;
+            existing = create && fd < 0 && errno == EEXIST;
+            if (fd < 0 && (existing || !create))
+                fd = shm_open(name, O_RDWR, 0600);
+            if (fd < 0)
+                return false;
+            owner = create;
+            if (create && ftruncate(fd, (off_t)size) != 0) {
+                close();
+                return false;
+            }
+            view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (view == MAP_FAILED)
+                view = nullptr;
+#endif
+            if (!view)
+                close();
+            return view != nullptr;
+        }
+        void close(void)
+        {
+#ifdef _WIN32
+            if (view)
+                UnmapViewOfFile(view);
+            if (handle)
+                CloseHandle(handle);
+            handle = NULL;
+#else
+            if (view)
+                munmap(view, size);
+            if (fd >= 0)
+                ::close(fd);
+            if (owner)
+                shm_unlink(name);
+            fd = -1;
+            owner = false;
+#endif
+            view = nullptr;
+        }
+        void* get(void) const
+        {
+            return view;
+        }
+        // True when open(create) attached to an object that was already there
+        bool existed(void) const
+        {
+            return existing;
+        }
+        // Drops a POSIX object left behind by a process that was killed, a file mapping goes away with its last handle
+        static void remove(const char* objectname)
+        {
+#ifndef _WIN32
+            char path[64];
+            snprintf(path, sizeof(path), "/%s", objectname);
+            shm_unlink(path);
+#endif
+        }
+};
+#endif
\ No newline at end of file
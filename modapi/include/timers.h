@@ -0,0 +1,29 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "eventmanager.h"
+#include "timerwheel.h"
+
+// SetTimeout/SetInterval/ClearTimer for the mods, in milliseconds, fired from the tick
+class Timers {
+    private:
+        static inline TimerWheel<EventManager::Listener> wheel;
+        static inline std::vector<uint64_t> expired;
+        static inline std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        // 0 for the steady clock, otherwise the time moves by this much per tick
+        static inline std::chrono::microseconds tickperiod{ 0 };
+        static uint64_t getnow(void);
+    public:
+        static uint64_t settimeout(int64_t milliseconds, sol::protected_function callback);
+        static uint64_t setinterval(int64_t milliseconds, sol::protected_function callback);
+        static bool cleartimer(uint64_t id);
+        static size_t count(void);
+        // SetTimeout timers still waiting to fire
+        static size_t countpending(void);
+        static void update(void);
+        // The headless runner doesn't wait between ticks, its timers follow the tick count instead of the clock
+        static void settickclock(std::chrono::microseconds period);
+};
+#endif
\ No newline at end of file
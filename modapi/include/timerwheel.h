@@ -0,0 +1,219 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+// Hierarchical timing wheel (4 levels of 64 slots, 1 time unit per level 0 slot).
+// schedule/cancel are O(1), advance only looks at the slot of each elapsed time unit and
+// cascades a higher level slot every 64 units, so pending timers cost nothing until they are due.
+// Handles pack a node index with a generation so a stale handle never cancels a reused node.
+template <typename T>
+class TimerWheel {
+    private:
+        static constexpr int LEVELS = 4;
+        static constexpr int SLOT_BITS = 6;
+        static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+        enum class State : uint8_t { Free, Armed, Firing, Cancelled };
+        struct Node {
+            uint64_t expires;
+            uint64_t interval;
+            uint32_t generation;
+            uint32_t prev;
+            uint32_t next;
+            uint16_t bucket;
+            State state;
+            T payload;
+        };
+        std::vector<Node> nodes;
+        uint32_t freelist = NONE;
+        uint32_t buckets[LEVELS * SLOTS];
+        uint64_t current = 0;
+        size_t armed = 0;
+
+        static uint64_t makehandle(uint32_t index, uint32_t generation)
+        {
+            return ((uint64_t)generation << 32) | (index + 1);
+        }
+        Node* find(uint64_t handle)
+        {
+            uint32_t index = (uint32_t)(handle & 0xFFFFFFFF) - 1;
+
+            if (handle == 0 || index >= nodes.size() || nodes[index].generation != (uint32_t)(handle >> 32) || nodes[index].state == State::Free)
+                return nullptr;
+            return &nodes[index];
+        }
+        void link(uint32_t index)
+        {
+            Node& node = nodes[index];
+            uint64_t delta = node.expires > current ? node.expires - current : 0;
+            int level = 0;
+
+            while (level < LEVELS - 1 && delta >= ((uint64_t)1 << (SLOT_BITS * (level + 1))))
+                level++;
+            // anything past the top level range parks in the furthest top slot and gets re-placed when it cascades
+            uint64_t when = delta >= ((uint64_t)1 << (SLOT_BITS * LEVELS)) ? current + ((uint64_t)(SLOTS - 1) << (SLOT_BITS * (LEVELS - 1))) : node.expires;
+            node.bucket = (uint16_t)(level * SLOTS + ((when >> (SLOT_BITS * level)) & (SLOTS - 1)));
+            node.prev = NONE;
+            node.next = buckets[node.bucket];
+            if (node.next != NONE)
+                nodes[node.next].prev = index;
+            buckets[node.bucket] = index;
+            armed++;
+        }
+        void unlink(uint32_t index)
+        {
+            Node& node = nodes[index];
+
+            if (node.prev != NONE)
+                nodes[node.prev].next = node.next;
+            else
+                buckets[node.bucket] = node.next;
+            if (node.next != NONE)
+                nodes[node.next].prev = node.prev;
+            armed--;
+        }
+        void release(uint32_t index)
+        {
+            Node& node = nodes[index];
+
+            node.state = State::Free;
+            node.generation++;
+            node.payload = T();
+            node.next = freelist;
+            freelist = index;
+        }
+        void cascade(int level)
+        {
+            uint32_t bucket = level * SLOTS + ((current >> (SLOT_BITS * level)) & (SLOTS - 1));
+            uint32_t index = buckets[bucket];
+
+            buckets[bucket] = NONE;
+            while (index != NONE) {
+                uint32_t next = nodes[index].next;
+                armed--;
+                link(index);
+                index = next;
+            }
+        }
+    public:
+        TimerWheel(uint64_t now = 0) : current(now)
+        {
+            for (uint32_t& bucket : buckets)
+                bucket = NONE;
+        }
+
+        uint64_t schedule(uint64_t delay, uint64_t interval, T payload)
+        {
+            uint32_t index;
+
+            if (freelist != NONE) {
+                index = freelist;
+                freelist = nodes[index].next;
+            } else {
+                index = (uint32_t)nodes.size();
+                nodes.push_back(Node{});
+            }
+            Node& node = nodes[index];
+            node.expires = current + (delay > 0 ? delay : 1);
+            node.interval = interval;
+            node.state = State::Armed;
+            node.payload = std::move(payload);
+            link(index);
+            return makehandle(index, node.generation);
+        }
+
+        bool cancel(uint64_t handle)
+        {
+            Node* node = find(handle);
+
+            if (!node || node->state == State::Cancelled)
+                return false;
+            uint32_t index = (uint32_t)(node - nodes.data());
+            // a timer cancelled from its own callback is released once the callback returns (see complete)
+            if (node->state == State::Firing) {
+                node->state = State::Cancelled;
+                return true;
+            }
+            unlink(index);
+            release(index);
+            return true;
+        }
+
+        // Moves the wheel up to now and appends the handles of every timer that expired, they stay allocated until complete()
+        void advance(uint64_t now, std::vector<uint64_t>& expired)
+        {
+            if (armed == 0 && current < now) {
+                current = now;
+                return;
+            }
+            while (current < now) {
+                current++;
+                for (int level = 1; level < LEVELS; level++) {
+                    if ((current & (((uint64_t)1 << (SLOT_BITS * level)) - 1)) != 0)
+                        break;
+                    cascade(level);
+                }
+                uint32_t bucket = (uint32_t)(current & (SLOTS - 1));
+                uint32_t index = buckets[bucket];
+                buckets[bucket] = NONE;
+                while (index != NONE) {
+                    Node& node = nodes[index];
+                    uint32_t next = node.next;
+                    armed--;
+                    node.state = State::Firing;
+                    expired.push_back(makehandle(index, node.generation));
+                    index = next;
+                }
+            }
+        }
+
+        T* get(uint64_t handle)
+        {
+            Node* node = find(handle);
+
+            return node && node->state == State::Firing ? &node->payload : nullptr;
+        }
+
+        // Called once the expired timer has been handled, re-arms intervals and frees the rest
+        void complete(uint64_t handle)
+        {
+            Node* node = find(handle);
+
+            if (!node)
+                return;
+            uint32_t index = (uint32_t)(node - nodes.data());
+            if (node->state == State::Firing && node->interval > 0) {
+                node->state = State::Armed;
+                node->expires = current + node->interval;
+                link(index);
+            } else if (node->state != State::Armed) {
+                release(index);
+            }
+        }
+
+        size_t size(void) const
+        {
+            return armed;
+        }
+
+        // Armed timers that only fire once, an interval stays armed until it's cancelled
+        size_t countoneshot(void) const
+        {
+            size_t count = 0;
+
+            for (const Node& node : nodes) {
+                if (node.state == State::Armed && node.interval == 0)
+                    count++;
+            }
+            return count;
+        }
+
+        uint64_t now(void) const
+        {
+            return current;
+        }
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+#include <cstdint>
+#include <chrono>
+#include <sol/sol.hpp>
+
+// Execution budget of one mod callback, enforced by a lua count hook so a runaway listener can't hang the tick.
+// An overrun raises a lua error in the callback (and keeps raising it until the callback is gone, a pcall can't swallow it).
+class Watchdog {
+    private:
+        // instructions between two budget checks
+        static constexpr int CHECK_INTERVAL = 1000;
+        static inline int64_t instructionbudget = 5000000;
+        static inline std::chrono::milliseconds timebudget{ 100 };
+        static inline int maxoverruns = 3;
+        static inline int depth = 0;
+        static inline int64_t executed = 0;
+        static inline std::chrono::steady_clock::time_point deadline;
+        static inline bool overrun = false;
+        static void hook(lua_State* L, lua_Debug* ar);
+    public:
+        static void init(void);
+        static void begin(lua_State* L);
+        // Returns true when the callback was aborted because it ran over its budget
+        static bool end(lua_State* L);
+        // Time left to the running callback, milliseconds::max() when nothing limits it
+        static std::chrono::milliseconds remaining(void);
+        static int getmaxoverruns(void);
+};
+#endif
\ No newline at end of file
@@ -12,6 +12,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -20,29 +36,7 @@
 
 void Mission::init()
 {
-    mission = MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C;
+    FieldRegistry::setroot(FieldObject::Mission, MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C);
 }
 
-int Mission::getid()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(mission, {0x1B0});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Mission::setid(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(mission, {0x1B0});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Mission::getcompletedsidemissions()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(mission, {0x18C});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Mission::setcompletedsidemission(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(mission, {0x18C});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
\ No newline at end of file
+MODAPI_MISSION_FIELDS(MODAPI_FIELD_DEFINE)
\ No newline at end of file
@@ -12,6 +12,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -20,132 +36,14 @@
 
 void Player::init()
 {
-    player = MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C;
+    FieldRegistry::setroot(FieldObject::Player, MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C);
 }
 
-int Player::getmoney()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x174});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setmoney(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x174});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getmaxcargo()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x0});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setmaxcargo(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x0});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getcargo()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x10});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setcargo(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x10});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getshiparmor()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x20});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setshiparmor(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x20});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
+MODAPI_PLAYER_FIELDS(MODAPI_FIELD_DEFINE)
 
 bool Player::hasshiparmor()
 {
     if (getshiparmor() != 0)
         return true;
     return false;
-}
-
-int Player::getmaxshiphealth()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x4});
-    return MemoryUtils::Read<int>(finaladdr); 
-}
-
-void Player::setmaxshiphealth(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x154, 0x4});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getenemieskilled()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x188});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setenemieskilled(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x188});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getlevel()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x190});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setlevel(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x190});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getvisitedstations()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x198});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setvisitedstations(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x198});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getjumpgateusedcount()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x198});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setjumpgateusedcount(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x198});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int Player::getcargotookcount()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x1A8});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Player::setcargotookcount(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(player, {0x1A8});
-    MemoryUtils::Write<int>(finaladdr, value);
 }
\ No newline at end of file
@@ -12,6 +12,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -20,41 +36,7 @@
 
 void Station::init()
 {
-    station = MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C;
+    FieldRegistry::setroot(FieldObject::Station, MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C);
 }
 
-int Station::getid()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(station, {0x160, 0x8});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Station::setid(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(station, {0x160, 0x8});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-std::string Station::getname()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(station, {0x160, 0x0, 0x0});
-    return MemoryUtils::ReadWideString(finaladdr);
-}
-
-void Station::setname(const std::string value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(station, {0x160, 0x0, 0x0});
-    MemoryUtils::WriteWideString(finaladdr, value);
-}
-
-int Station::gettechlevel()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(station, {0x160, 0x1C});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void Station::settechlevel(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(station, {0x160, 0x1C});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
\ No newline at end of file
+MODAPI_STATION_FIELDS(MODAPI_FIELD_DEFINE)
\ No newline at end of file
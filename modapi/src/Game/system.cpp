@@ -12,6 +12,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -20,89 +36,7 @@
 
 void System::init()
 {
-    system = MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C;
+    FieldRegistry::setroot(FieldObject::System, MemoryUtils::GetModuleBase("GoF2.exe") + 0x20AD6C);
 }
 
-int System::getid()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x14});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void System::setid(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x14});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int System::getrisklevel()
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x18});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void System::setrisklevel(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x18});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int System::getfaction(void)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x1C});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void System::setfaction(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x1C});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int System::getjumpgatestationid(void)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x2C});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void System::setjumpgatestationid(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x2C});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int System::getmapcoordinatex(void)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x20});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void System::setmapcoordinatex(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x20});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int System::getmapcoordinatey(void)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x24});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void System::setmapcoordinatey(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x24});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
-
-int System::getmapcoordinatez(void)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x28});
-    return MemoryUtils::Read<int>(finaladdr);
-}
-
-void System::setmapcoordinatez(int value)
-{
-    uintptr_t finaladdr = MemoryUtils::GetPointerAddress(system, {0x168, 0x28});
-    MemoryUtils::Write<int>(finaladdr, value);
-}
\ No newline at end of file
+MODAPI_SYSTEM_FIELDS(MODAPI_FIELD_DEFINE)
\ No newline at end of file
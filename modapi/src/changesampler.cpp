@@ -0,0 +1,136 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+// the fields behind the change events of EventManager
+static constexpr FieldId watched[] = { FieldId::System_id, FieldId::Player_money };
+
+int64_t ChangeSampler::getnow()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ChangeSampler::sample(Watch& watch, int64_t now)
+{
+    int value;
+
+    // a broken chain (loading, menu) isn't a change, the next valid value is compared to the last valid one
+    if (FieldRegistry::tryread_int(watch.id, value) && (!watch.known || value != watch.value)) {
+        if (!watch.known) {
+            watch.known = true;
+            watch.queued = value;
+        } else if (watch.pending) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        watch.value = value;
+        watch.pending = watch.value != watch.queued;
+    }
+    if (!watch.pending)
+        return;
+    if (queue.push({ watch.id, watch.value, watch.queued, EventManager::gettick(), now })) {
+        watch.queued = watch.value;
+        watch.pending = false;
+    }
+}
+
+void ChangeSampler::samplerloop()
+{
+    auto next = std::chrono::steady_clock::now();
+
+    while (running.load(std::memory_order_relaxed)) {
+        int64_t now = getnow();
+        for (Watch& watch : watches)
+            sample(watch, now);
+        FieldSeries::sampleall(now);
+        next += period;
+        auto current = std::chrono::steady_clock::now();
+        // after a stall (debugger, the game freezing) start again from now instead of catching up
+        if (next < current)
+            next = current;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void ChangeSampler::setup()
+{
+    int rate = Config::getint("sampler.rate_hz", 1000);
+
+    period = std::chrono::microseconds(1000000 / std::clamp(rate, 1, 10000));
+    watches.clear();
+    for (FieldId id : watched)
+        watches.push_back({ id, false, 0, 0, false });
+}
+
+void ChangeSampler::start()
+{
+    setup();
+    running = true;
+    sampler = std::thread(samplerloop);
+}
+
+void ChangeSampler::poll()
+{
+    int64_t now = getnow();
+
+    if (watches.empty())
+        setup();
+    for (Watch& watch : watches)
+        sample(watch, now);
+    FieldSeries::sampleall(now);
+}
+
+void ChangeSampler::stop()
+{
+    running = false;
+    if (sampler.joinable())
+        sampler.join();
+}
+
+bool ChangeSampler::take(Change& change)
+{
+    return queue.pop(change);
+}
+
+double ChangeSampler::getrate()
+{
+    return 1000000.0 / period.count();
+}
+
+uint64_t ChangeSampler::takedropped()
+{
+    return dropped.exchange(0, std::memory_order_relaxed);
+}
\ No newline at end of file
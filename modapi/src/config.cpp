@@ -0,0 +1,132 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <fstream>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+static std::string trim(const std::string& str)
+{
+    size_t begin = str.find_first_not_of(" \t\r\n");
+    size_t end = str.find_last_not_of(" \t\r\n");
+
+    if (begin == std::string::npos)
+        return std::string();
+    return str.substr(begin, end - begin + 1);
+}
+
+bool Config::load(const std::string& filepath)
+{
+    std::ifstream file(filepath);
+    std::string line;
+
+    if (!file.is_open())
+        return false;
+    while (std::getline(file, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        size_t separator = line.find('=');
+        if (separator == std::string::npos)
+            continue;
+        std::string key = trim(line.substr(0, separator));
+        if (!key.empty())
+            values[key] = trim(line.substr(separator + 1));
+    }
+    return true;
+}
+
+void Config::set(const std::string& key, const std::string& value)
+{
+    values[key] = value;
+}
+
+bool Config::has(const std::string& key)
+{
+    return values.find(key) != values.end();
+}
+
+std::string Config::getstring(const std::string& key, const std::string& fallback)
+{
+    auto it = values.find(key);
+
+    if (it == values.end())
+        return fallback;
+    return it->second;
+}
+
+int Config::getint(const std::string& key, int fallback)
+{
+    auto it = values.find(key);
+
+    if (it == values.end())
+        return fallback;
+    try {
+        return std::stoi(it->second, nullptr, 0);
+    }
+    catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+bool Config::getbool(const std::string& key, bool fallback)
+{
+    auto it = values.find(key);
+
+    if (it == values.end())
+        return fallback;
+    return it->second == "true" || it->second == "1" || it->second == "yes" || it->second == "on";
+}
+
+std::vector<unsigned int> Config::getoffsets(const std::string& key)
+{
+    std::vector<unsigned int> offsets;
+    auto it = values.find(key);
+
+    if (it == values.end())
+        return offsets;
+    size_t begin = 0;
+    while (begin <= it->second.size()) {
+        size_t end = it->second.find(',', begin);
+        if (end == std::string::npos)
+            end = it->second.size();
+        try {
+            offsets.push_back((unsigned int)std::stoul(trim(it->second.substr(begin, end - begin)), nullptr, 0));
+        }
+        catch (const std::exception&) {
+            return {};
+        }
+        begin = end + 1;
+    }
+    return offsets;
+}
\ No newline at end of file
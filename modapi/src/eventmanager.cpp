@@ -8,61 +8,124 @@
 #include <sol/sol.hpp>
 #include <map>
 #include <string>
+#include <chrono>
 #include "modapi_utils.h"
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
 #include <Game/mission.h>
 #include <Game/asset.h>
+#include "timers.h"
+#include "sharedstore.h"
+#include "fileio.h"
 
-std::map<std::string, std::vector<sol::protected_function>> EventManager::listeners;
+std::map<std::string, std::vector<EventManager::Listener>> EventManager::listeners;
 
 void EventManager::addlistener(std::string eventname, sol::protected_function callback)
 {
-    listeners[eventname].push_back(callback);
+    if (dispatching)
+        deferred.push_back({ eventname, { ModContext::getcurrent(), callback } });
+    else
+        listeners[eventname].push_back({ ModContext::getcurrent(), callback });
+}
+
+void EventManager::adddeferred()
+{
+    for (auto& [eventname, listener] : deferred)
+        listeners[eventname].push_back(std::move(listener));
+    deferred.clear();
 }
 
 void EventManager::clearlisteners()
 {
     listeners.clear();
+    deferred.clear();
+}
+
+// Only transitions are reported, mods that need the phase at any time read game.phase
+void EventManager::phase_event()
+{
+    Phase previous;
+
+    if (!GamePhase::update(previous))
+        return;
+    Phase current = GamePhase::get();
+    int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    trigger("OnPhaseChanged", GamePhase::getname(current), GamePhase::getname(previous), gettick(), getseconds(now));
+    if (!GamePhase::isingame(previous) && GamePhase::isingame(current))
+        trigger("OnEnterGame");
+    if (current == Phase::Docked)
+        trigger("OnDock");
+    if (previous == Phase::Docked && current == Phase::InSpace)
+        trigger("OnUndock");
+    if (GamePhase::isingame(previous) && !GamePhase::isingame(current))
+        trigger("OnExitToMenu");
+    // nobody notices a hitch in the menu or while docking, good time for a full lua collection
+    if (current != Phase::InSpace)
+        LuaManager::requestfullgc();
 }
 
+// IsInGame/IsInMainMenu fire every tick of the phase, they predate the transition events and the mods written for them still use them
 void EventManager::ingame_event()
 {
-    // <1000 because when the game init the pointer it has some random values so the in game event gets triggered
-    // TODO: Do a better ingame event impl because if we go in game and then go back to the main menu the pointer still has the mission id value
-    if (Mission::getid() > 0 && Mission::getid() < 1000)
+    if (GamePhase::isingame(GamePhase::get()))
         trigger("IsInGame");
 }
 
 void EventManager::mainmenu_event()
 {
-    if (Mission::getid() == 0)
+    if (GamePhase::get() == Phase::MainMenu)
         trigger("IsInMainMenu");
 }
 
-void EventManager::systemchanged_event()
+void EventManager::telemetry_event()
 {
-    static int old = System::getid();
-    int current = System::getid();
+    std::vector<std::string> commands;
 
-    if (current != old) {
-        trigger("OnSystemChanged", current);
-        old = current;
-    }
+    Telemetry::takecommands(commands);
+    for (const auto& command : commands)
+        trigger("OnTelemetryCommand", command);
 }
 
-void EventManager::moneychanged_event()
+// At most one queue worth of changes per tick, the sampler keeps adding some while the listeners run
+void EventManager::changes_event()
 {
-    static int old = Player::getmoney();
-    int current = Player::getmoney();
+    ChangeSampler::Change change;
+    uint64_t dropped = ChangeSampler::takedropped();
 
-    if (current != old) {
-        trigger("OnMoneyChanged", current);
-        old = current;
+    if (dropped > 0)
+        Logger::warning("EventManager", "The change queue was full, {} intermediate values were skipped", dropped);
+    for (size_t i = 0; i < ChangeSampler::QUEUE_SIZE && ChangeSampler::take(change); i++) {
+        switch (change.id) {
+        case FieldId::System_id:
+            trigger("OnSystemChanged", change.value, change.previous, change.tick, getseconds(change.timestamp));
+            LuaManager::requestfullgc();
+            break;
+        case FieldId::Player_money:
+            trigger("OnMoneyChanged", change.value, change.previous, change.tick, getseconds(change.timestamp));
+            break;
+        default:
+            break;
+        }
     }
 }
 
@@ -73,9 +136,54 @@ void EventManager::update_event()
 
 void EventManager::trigger_events()
 {
+    tick.fetch_add(1, std::memory_order_relaxed);
+    FieldRegistry::refresh();
+    Galaxy::refresh();
     update_event();
-    systemchanged_event();
-    moneychanged_event();
+    Timers::update();
+    FileIO::dispatch();
+    MemoryScanner::dispatch();
+    SharedStore::dispatch();
+    telemetry_event();
+    phase_event();
     mainmenu_event();
     ingame_event();
+    changes_event();
+    Telemetry::publish();
+}
+
+uint64_t EventManager::gettick()
+{
+    return tick.load(std::memory_order_relaxed);
+}
+
+double EventManager::getseconds(int64_t microseconds)
+{
+    return microseconds / 1000000.0;
+}
+
+void EventManager::record(int mod, std::string_view kind, std::string_view name, std::chrono::steady_clock::duration elapsed, bool aborted)
+{
+    int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+    if ((size_t)mod >= callstats.size())
+        callstats.resize(mod + 1);
+    CallStats& stats = callstats[mod];
+    stats.calls++;
+    stats.time += microseconds;
+    if (aborted)
+        stats.overruns++;
+    if (microseconds > stats.worst) {
+        stats.worst = microseconds;
+        stats.worstname = std::string(kind) + " '" + std::string(name) + "'";
+    }
+}
+
+const EventManager::CallStats& EventManager::getcallstats(int mod)
+{
+    static const CallStats empty;
+
+    if ((size_t)mod >= callstats.size())
+        return empty;
+    return callstats[mod];
 }
\ No newline at end of file
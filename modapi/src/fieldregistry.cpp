@@ -0,0 +1,303 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+// Two int fields further apart than this end up in separate reads instead of one big span
+static constexpr unsigned int MAX_GROUP_GAP = 0x40;
+static_assert((size_t)FieldId::Count <= 64, "FieldSnapshot::validmask has one bit per field");
+
+const FieldInfo FieldRegistry::fields[(size_t)FieldId::Count] = {
+#define MODAPI_FIELD_INFO(object, name, luaname, type, access, ...) \
+    { FieldObject::object, #object, luaname, MODAPI_FIELD_KIND_##type, MODAPI_FIELD_ACCESS_##access, { __VA_ARGS__ } },
+    MODAPI_FIELDS(MODAPI_FIELD_INFO)
+#undef MODAPI_FIELD_INFO
+};
+
+void FieldRegistry::setroot(FieldObject object, uintptr_t root)
+{
+    roots[(size_t)object] = root;
+}
+
+uintptr_t FieldRegistry::getroot(FieldObject object)
+{
+    return roots[(size_t)object];
+}
+
+uintptr_t FieldRegistry::getaddress(FieldId id)
+{
+    const FieldInfo& info = fields[(size_t)id];
+    return MemoryUtils::GetPointerAddress(roots[(size_t)info.object], info.offsets);
+}
+
+void FieldRegistry::build()
+{
+    struct Entry {
+        size_t id;
+        uintptr_t root;
+        std::vector<unsigned int> chain;
+        unsigned int offset;
+    };
+    std::vector<Entry> entries;
+
+    for (size_t i = 0; i < (size_t)FieldId::Count; i++) {
+        const FieldInfo& info = fields[i];
+
+        for (size_t j = 0; j < i; j++) {
+            if (fields[j].object == info.object && fields[j].offsets == info.offsets)
+                Logger::warning("FieldRegistry", "{}.{} reads the same memory as {}.{}", info.objectname, info.luaname, fields[j].objectname, fields[j].luaname);
+        }
+        if (info.type != FieldType::Int || info.offsets.empty())
+            continue;
+        // the last offset is applied to the final pointer so a trailing 0 gives us the shared base of the group
+        std::vector<unsigned int> chain(info.offsets.begin(), info.offsets.end() - 1);
+        chain.push_back(0);
+        entries.push_back({ i, roots[(size_t)info.object], chain, info.offsets.back() });
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.root != b.root)
+            return a.root < b.root;
+        if (a.chain != b.chain)
+            return a.chain < b.chain;
+        return a.offset < b.offset;
+    });
+
+    plan.clear();
+    slots.assign((size_t)FieldId::Count, npos);
+    groupof.assign((size_t)FieldId::Count, npos);
+    size_t size = 0;
+    for (const Entry& entry : entries) {
+        bool merge = !plan.empty() && plan.back().root == entry.root && plan.back().chain == entry.chain && entry.offset <= plan.back().end + MAX_GROUP_GAP;
+
+        if (!merge) {
+            if (!plan.empty())
+                size += plan.back().end - plan.back().begin;
+            plan.push_back({ entry.root, entry.chain, entry.offset, entry.offset + (unsigned int)sizeof(int), size, false, 0 });
+        }
+        ReadGroup& group = plan.back();
+        group.end = (std::max)(group.end, entry.offset + (unsigned int)sizeof(int));
+        slots[entry.id] = group.snapshotoffset + (entry.offset - group.begin);
+        groupof[entry.id] = plan.size() - 1;
+    }
+    if (!plan.empty())
+        size += plan.back().end - plan.back().begin;
+    snapshot.assign(size, 0);
+    Logger::info("FieldRegistry", "{} fields planned in {} reads ({} bytes)", entries.size(), plan.size(), size);
+}
+
+void FieldRegistry::refresh()
+{
+    for (ReadGroup& group : plan) {
+        uint8_t* dest = snapshot.data() + group.snapshotoffset;
+        size_t size = group.end - group.begin;
+        uintptr_t base = MemoryUtils::GetPointerAddress(group.root, group.chain);
+
+        group.valid = base != 0 && ReadProcessMemory(GetCurrentProcess(), (LPCVOID)(base + group.begin), dest, size, NULL);
+        group.base = group.valid ? base : 0;
+        if (!group.valid)
+            memset(dest, 0, size);
+    }
+    if (!pins.empty())
+        enforcepins();
+    publish();
+}
+
+void FieldRegistry::publish()
+{
+    FieldSnapshot next = {};
+    uint64_t current = generation.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < (size_t)FieldId::Count; i++) {
+        next.values[i] = cached((FieldId)i);
+        if (isvalid((FieldId)i))
+            next.validmask |= 1ull << i;
+    }
+    if (current > 0 && next.validmask == lastpublished.validmask && memcmp(next.values, lastpublished.values, sizeof(next.values)) == 0)
+        return;
+    next.generation = current + 1;
+    next.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    published[next.generation & 1].store(next);
+    generation.store(next.generation, std::memory_order_release);
+    lastpublished = next;
+}
+
+bool FieldRegistry::getpublished(FieldSnapshot& out)
+{
+    uint64_t current = generation.load(std::memory_order_acquire);
+
+    if (current == 0)
+        return false;
+    out = published[current & 1].load();
+    return true;
+}
+
+uint64_t FieldRegistry::getgeneration()
+{
+    return generation.load(std::memory_order_acquire);
+}
+
+// Reuses the group bases resolved by the refresh, so a pin costs a compare and, only when the game moved the value, one write
+void FieldRegistry::enforcepins()
+{
+    for (const Pin& pin : pins) {
+        size_t group = groupof[(size_t)pin.id];
+
+        if (group == npos || !plan[group].valid || cached(pin.id) == pin.value)
+            continue;
+        uintptr_t address = plan[group].base + fields[(size_t)pin.id].offsets.back();
+        if (MemoryUtils::Write<int>(address, pin.value))
+            memcpy(snapshot.data() + slots[(size_t)pin.id], &pin.value, sizeof(pin.value));
+    }
+}
+
+FieldId FieldRegistry::find(std::string_view name)
+{
+    size_t dot = name.find('.');
+
+    if (dot == std::string_view::npos)
+        return FieldId::Count;
+    std::string_view object = name.substr(0, dot);
+    std::string_view luaname = name.substr(dot + 1);
+    for (size_t i = 0; i < (size_t)FieldId::Count; i++) {
+        std::string_view objectname = fields[i].objectname;
+        if (luaname != fields[i].luaname || objectname.size() != object.size())
+            continue;
+        // object names are "Player", "System"... the lua globals are lowercase
+        bool match = true;
+        for (size_t j = 0; j < object.size() && match; j++)
+            match = tolower((unsigned char)objectname[j]) == tolower((unsigned char)object[j]);
+        if (match)
+            return (FieldId)i;
+    }
+    return FieldId::Count;
+}
+
+bool FieldRegistry::pin(FieldId id, int value, int mod)
+{
+    const FieldInfo& info = fields[(size_t)id];
+
+    if (info.type != FieldType::Int || info.access != FieldAccess::ReadWrite || groupof.empty() || groupof[(size_t)id] == npos)
+        return false;
+    for (Pin& pin : pins) {
+        if (pin.id != id)
+            continue;
+        if (pin.mod != mod)
+            Logger::warning(ModContext::getname(mod), "{}.{} was pinned by {}, overriding it", info.objectname, info.luaname, ModContext::getname(pin.mod));
+        pin.value = value;
+        pin.mod = mod;
+        pinnedvalues[(size_t)id].store(value, std::memory_order_relaxed);
+        return true;
+    }
+    pins.push_back({ id, value, mod });
+    pinnedvalues[(size_t)id].store(value, std::memory_order_relaxed);
+    pinned[(size_t)id].store(true, std::memory_order_release);
+    return true;
+}
+
+bool FieldRegistry::unpin(FieldId id, int mod)
+{
+    for (size_t i = 0; i < pins.size(); i++) {
+        if (pins[i].id != id)
+            continue;
+        if (pins[i].mod != mod) {
+            const FieldInfo& info = fields[(size_t)id];
+            Logger::warning(ModContext::getname(mod), "{}.{} is pinned by {}, only it can unpin it", info.objectname, info.luaname, ModContext::getname(pins[i].mod));
+            return false;
+        }
+        pins.erase(pins.begin() + i);
+        pinned[(size_t)id].store(false, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+size_t FieldRegistry::groupcount()
+{
+    return plan.size();
+}
+
+bool FieldRegistry::isvalid(FieldId id)
+{
+    size_t group = groupof.empty() ? npos : groupof[(size_t)id];
+
+    return group != npos && plan[group].valid;
+}
+
+int FieldRegistry::cached(FieldId id)
+{
+    size_t slot = slots.empty() ? npos : slots[(size_t)id];
+    int value = 0;
+
+    if (slot != npos)
+        memcpy(&value, snapshot.data() + slot, sizeof(value));
+    return value;
+}
+
+int FieldRegistry::read_int(FieldId id)
+{
+    return MemoryUtils::Read<int>(getaddress(id));
+}
+
+bool FieldRegistry::tryread_int(FieldId id, int& value)
+{
+    uintptr_t address = getaddress(id);
+
+    if (address == 0)
+        return false;
+    // the sampler runs much faster than the tick, it would see the game's value and then the pin again as two changes
+    if (pinned[(size_t)id].load(std::memory_order_acquire)) {
+        value = pinnedvalues[(size_t)id].load(std::memory_order_relaxed);
+        return true;
+    }
+    return ReadProcessMemory(GetCurrentProcess(), (LPCVOID)address, &value, sizeof(value), NULL);
+}
+
+void FieldRegistry::write_int(FieldId id, int value)
+{
+    MemoryUtils::Write<int>(getaddress(id), value);
+}
+
+std::string FieldRegistry::read_wstring(FieldId id)
+{
+    return MemoryUtils::ReadWideString(getaddress(id));
+}
+
+void FieldRegistry::write_wstring(FieldId id, const std::string& value)
+{
+    MemoryUtils::WriteWideString(getaddress(id), value);
+}
\ No newline at end of file
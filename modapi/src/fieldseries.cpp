@@ -0,0 +1,210 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <algorithm>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+FieldSeries::FieldSeries(FieldId id, int mod, int64_t interval, size_t capacity)
+    : id(id), mod(mod), memory(getmemory(capacity)), interval(interval), capacity(capacity), values(capacity), times(capacity)
+{
+    minimums.items.resize(capacity);
+    maximums.items.resize(capacity);
+}
+
+// Can run on the sampler thread when it held the last reference
+FieldSeries::~FieldSeries()
+{
+    std::lock_guard<std::mutex> lock(memorymutex);
+
+    modmemory[mod] -= memory;
+    LuaAllocator::uncharge(mod, memory);
+}
+
+size_t FieldSeries::getmemory(size_t capacity)
+{
+    return capacity * (sizeof(int) + sizeof(int64_t) + 2 * sizeof(uint64_t));
+}
+
+std::shared_ptr<FieldSeries> FieldSeries::create(FieldId id, int mod, int64_t interval, size_t capacity)
+{
+    size_t memory = getmemory(capacity);
+
+    {
+        std::lock_guard<std::mutex> lock(memorymutex);
+        size_t& used = modmemory[mod];
+        if (used + memory > MAX_MOD_MEMORY || !LuaAllocator::charge(mod, memory))
+            return nullptr;
+        used += memory;
+    }
+    auto series = std::make_shared<FieldSeries>(id, mod, interval, capacity);
+    std::lock_guard<std::mutex> lock(activemutex);
+    active.push_back(series);
+    return series;
+}
+
+void FieldSeries::push(int value, int64_t time)
+{
+    uint64_t index = count;
+
+    if (count >= capacity) {
+        uint64_t oldest = count - capacity;
+        sum -= values[oldest % capacity];
+        if (minimums.front() == oldest)
+            minimums.popfront();
+        if (maximums.front() == oldest)
+            maximums.popfront();
+    }
+    values[index % capacity] = value;
+    times[index % capacity] = time;
+    sum += value;
+    // a sample can't be the min/max of the window anymore once a newer one is smaller/bigger
+    while (!minimums.empty() && values[minimums.back() % capacity] >= value)
+        minimums.popback();
+    minimums.push(index);
+    while (!maximums.empty() && values[maximums.back() % capacity] <= value)
+        maximums.popback();
+    maximums.push(index);
+    count++;
+}
+
+void FieldSeries::remove(const FieldSeries* series)
+{
+    std::lock_guard<std::mutex> lock(activemutex);
+
+    active.erase(std::remove_if(active.begin(), active.end(), [series](const std::weak_ptr<FieldSeries>& entry) {
+        auto locked = entry.lock();
+        return !locked || locked.get() == series;
+    }), active.end());
+}
+
+void FieldSeries::sampleall(int64_t now)
+{
+    std::lock_guard<std::mutex> lock(activemutex);
+    bool expired = false;
+
+    for (const auto& entry : active) {
+        auto series = entry.lock();
+        int value;
+        if (!series) {
+            expired = true;
+            continue;
+        }
+        if (now < series->nextsample)
+            continue;
+        // behind after a stall: skip the missed samples instead of taking them all at once
+        series->nextsample = (std::max)(series->nextsample + series->interval, now);
+        if (!FieldRegistry::tryread_int(series->id, value))
+            continue;
+        std::lock_guard<std::mutex> serieslock(series->mutex);
+        series->push(value, now);
+    }
+    if (expired) {
+        active.erase(std::remove_if(active.begin(), active.end(), [](const std::weak_ptr<FieldSeries>& entry) {
+            return entry.expired();
+        }), active.end());
+    }
+}
+
+size_t FieldSeries::getsize() const
+{
+    return (size_t)(std::min)(count, (uint64_t)capacity);
+}
+
+size_t FieldSeries::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return getsize();
+}
+
+std::optional<int> FieldSeries::getlast() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (count == 0)
+        return std::nullopt;
+    return values[(count - 1) % capacity];
+}
+
+std::optional<int> FieldSeries::getmin() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (count == 0)
+        return std::nullopt;
+    return values[minimums.front() % capacity];
+}
+
+std::optional<int> FieldSeries::getmax() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (count == 0)
+        return std::nullopt;
+    return values[maximums.front() % capacity];
+}
+
+std::optional<double> FieldSeries::getmean() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (count == 0)
+        return std::nullopt;
+    return (double)sum / getsize();
+}
+
+std::optional<double> FieldSeries::getrate() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t size = getsize();
+
+    if (size < 2)
+        return std::nullopt;
+    uint64_t newest = (count - 1) % capacity;
+    uint64_t oldest = (count - size) % capacity;
+    int64_t elapsed = times[newest] - times[oldest];
+    if (elapsed <= 0)
+        return std::nullopt;
+    return ((double)values[newest] - values[oldest]) * 1000000.0 / elapsed;
+}
+
+void FieldSeries::getwindow(std::vector<int>& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t size = getsize();
+
+    out.resize(size);
+    for (size_t i = 0; i < size; i++)
+        out[i] = values[(count - size + i) % capacity];
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+#include "fileio.h"
+
+std::string FileIO::takebuffer()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (buffers.empty())
+        return std::string();
+    std::string buffer = std::move(buffers.back());
+    buffers.pop_back();
+    return buffer;
+}
+
+void FileIO::releasebuffer(std::string&& buffer)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // a few huge files read once shouldn't stay in memory forever
+    if (buffers.size() >= MAX_POOLED || buffer.capacity() > MAX_POOLED_CAPACITY)
+        return;
+    buffer.clear();
+    buffers.push_back(std::move(buffer));
+}
+
+bool FileIO::getpath(int mod, const std::string& path, std::string& out)
+{
+    std::filesystem::path relative(path);
+    std::string directory = ModContext::getpath(mod);
+
+    if (path.empty() || relative.has_root_name() || relative.has_root_directory())
+        return false;
+    for (const auto& part : relative) {
+        if (part == "..")
+            return false;
+    }
+    out = (directory.empty() ? std::string(".") : directory) + "/" + path;
+    return true;
+}
+
+void FileIO::run(Job& job, Result& result)
+{
+    result.id = job.id;
+    result.ok = false;
+    if (job.operation == FileOperation::List) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(job.path, error)) {
+            // directories end with a / so the mod doesn't need another call to tell them apart
+            std::u8string filename = entry.path().filename().u8string();
+            std::string name(filename.begin(), filename.end());
+            result.entries.push_back(entry.is_directory(error) ? name + "/" : name);
+        }
+        if (error) {
+            result.error = error.message();
+            result.entries.clear();
+            return;
+        }
+        std::sort(result.entries.begin(), result.entries.end());
+        result.ok = true;
+        return;
+    }
+    bool reading = job.operation == FileOperation::Read;
+    FILE* file = fopen(job.path.c_str(), reading ? "rb" : job.operation == FileOperation::Append ? "ab" : "wb");
+    if (!file) {
+        result.error = "can't open " + job.path;
+        return;
+    }
+    if (reading) {
+        long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+        if (size < 0 || (size_t)size > MAX_FILE_SIZE) {
+            result.error = size < 0 ? "can't read " + job.path : job.path + " is too big";
+            fclose(file);
+            return;
+        }
+        rewind(file);
+        result.data = takebuffer();
+        result.data.resize((size_t)size);
+        result.ok = fread(result.data.data(), 1, result.data.size(), file) == result.data.size();
+    } else {
+        result.ok = fwrite(job.data.data(), 1, job.data.size(), file) == job.data.size();
+    }
+    result.ok = fclose(file) == 0 && result.ok;
+    if (!result.ok)
+        result.error = (reading ? "can't read " : "can't write ") + job.path;
+}
+
+void FileIO::workerloop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (running || !jobs.empty()) {
+        wakeup.wait(lock, [] { return !running || !jobs.empty(); });
+        if (jobs.empty())
+            continue;
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        Result result;
+        run(job, result);
+        std::string data = std::move(job.data);
+        if (data.capacity() > 0)
+            releasebuffer(std::move(data));
+        lock.lock();
+        completed.push_back(std::move(result));
+    }
+}
+
+void FileIO::start()
+{
+    int count = std::clamp(Config::getint("io.threads", 2), 1, 8);
+
+    running = true;
+    for (int i = 0; i < count; i++)
+        workers.emplace_back(workerloop);
+}
+
+void FileIO::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wakeup.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+}
+
+bool FileIO::queue(FileOperation operation, const std::string& path, const char* data, size_t size, Waiter waiter)
+{
+    Job job = { nextid++, operation };
+
+    if (!running || !getpath(waiter.listener.mod, path, job.path))
+        return false;
+    if (operation == FileOperation::Write || operation == FileOperation::Append) {
+        job.data = takebuffer();
+        job.data.assign(data, size);
+    }
+    pending[job.id] = { operation, path, std::move(waiter) };
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wakeup.notify_one();
+    return true;
+}
+
+size_t FileIO::count()
+{
+    return pending.size();
+}
+
+// (content / true / names, nil) on success, (nil, message) on failure
+int FileIO::pushresult(lua_State* L, FileOperation operation, Result& result)
+{
+    if (!result.ok) {
+        lua_pushnil(L);
+        lua_pushstring(L, result.error.c_str());
+        return 2;
+    }
+    if (operation == FileOperation::Read) {
+        lua_pushlstring(L, result.data.data(), result.data.size());
+    } else if (operation == FileOperation::List) {
+        lua_createtable(L, (int)result.entries.size(), 0);
+        for (size_t i = 0; i < result.entries.size(); i++) {
+            lua_pushstring(L, result.entries[i].c_str());
+            lua_rawseti(L, -2, (lua_Integer)i + 1);
+        }
+    } else {
+        lua_pushboolean(L, 1);
+    }
+    lua_pushnil(L);
+    return 2;
+}
+
+void FileIO::dispatch()
+{
+    std::deque<Result> results;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        results.swap(completed);
+    }
+    for (Result& result : results) {
+        auto it = pending.find(result.id);
+        if (it == pending.end())
+            continue;
+        Pending request = std::move(it->second);
+        pending.erase(it);
+        Waiter& waiter = request.waiter;
+        if (waiter.thread.valid()) {
+            lua_State* thread = waiter.thread.thread_state();
+            int returned;
+            ModContext::Scope scope(waiter.listener.mod);
+            int count = pushresult(thread, request.operation, result);
+            auto start = std::chrono::steady_clock::now();
+            Watchdog::begin(thread);
+            int status = lua_resume(thread, nullptr, count, &returned);
+            bool aborted = Watchdog::end(thread);
+            EventManager::record(waiter.listener.mod, "coroutine waiting for", request.path, std::chrono::steady_clock::now() - start, aborted);
+            if (status == LUA_OK || status == LUA_YIELD) {
+                lua_pop(thread, returned);
+            } else {
+                Logger::error(ModContext::getname(waiter.listener.mod), "Lua Error in coroutine waiting for '{}': {}", request.path, lua_tostring(thread, -1));
+                lua_pop(thread, 1);
+            }
+        } else {
+            lua_State* L = waiter.listener.callback.lua_state();
+            pushresult(L, request.operation, result);
+            sol::object value(L, -2);
+            sol::object error(L, -1);
+            lua_pop(L, 2);
+            EventManager::call(waiter.listener, "file callback", request.path, value, error);
+        }
+        if (result.data.capacity() > 0)
+            releasebuffer(std::move(result.data));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,382 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <algorithm>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+static constexpr int MAX_TABLE_SIZE = 4096;
+// bytes of a system/station struct read in one go, covers every int field of the schema
+static constexpr size_t ELEMENT_SPAN = 0x40;
+
+// offset of a field inside its system/station struct (last offset of its schema chain)
+static unsigned int getfieldoffset(FieldId id)
+{
+    return FieldRegistry::fields[(size_t)id].offsets.back();
+}
+
+static int getint(const uint8_t* element, FieldId id)
+{
+    int value = 0;
+    unsigned int offset = getfieldoffset(id);
+
+    if (offset + sizeof(int) <= ELEMENT_SPAN)
+        memcpy(&value, element + offset, sizeof(value));
+    return value;
+}
+
+bool Galaxy::loadtable(const std::string& name, Table& table)
+{
+    table.array = Config::getoffsets("galaxy." + name + ".array");
+    table.count = Config::getoffsets("galaxy." + name + ".count");
+    table.indirect = Config::getbool("galaxy." + name + ".indirect", true);
+    table.stride = (unsigned int)Config::getint("galaxy." + name + ".stride", table.indirect ? sizeof(uint32_t) : 0);
+    table.base = 0;
+    table.size = 0;
+    if (table.array.empty() || table.count.empty() || table.stride == 0) {
+        table.array.clear();
+        return false;
+    }
+    return true;
+}
+
+void Galaxy::init()
+{
+    modulebase = MemoryUtils::GetModuleBase("GoF2.exe");
+    bool systemsconfigured = loadtable("systems", systemtable);
+    bool stationsconfigured = loadtable("stations", stationtable);
+
+    if (!systemsconfigured || !stationsconfigured)
+        Logger::info("Galaxy", "Galaxy tables not configured, the catalog is filled with the visited systems/stations");
+    refresh();
+}
+
+// First offset is relative to GoF2.exe, the others are followed like the schema chains
+uintptr_t Galaxy::resolve(const std::vector<unsigned int>& chain)
+{
+    if (chain.empty() || modulebase == 0)
+        return 0;
+    return MemoryUtils::GetPointerAddress(modulebase + chain[0], std::vector<unsigned int>(chain.begin() + 1, chain.end()));
+}
+
+bool Galaxy::locate(Table& table, uintptr_t& base, int& size)
+{
+    if (table.array.empty())
+        return false;
+    base = resolve(table.array);
+    uintptr_t countaddr = resolve(table.count);
+    size = countaddr ? MemoryUtils::Read<int>(countaddr) : 0;
+    if (base == 0 || size <= 0 || size > MAX_TABLE_SIZE) {
+        base = 0;
+        size = 0;
+    }
+    return true;
+}
+
+uintptr_t Galaxy::getelement(const Table& table, uintptr_t base, int index)
+{
+    uintptr_t address = base + (uintptr_t)index * table.stride;
+
+    return table.indirect ? MemoryUtils::Read<uintptr_t>(address) : address;
+}
+
+void Galaxy::readsystems()
+{
+    uint8_t element[ELEMENT_SPAN];
+
+    systems = {};
+    for (int i = 0; i < systemtable.size; i++) {
+        uintptr_t address = getelement(systemtable, systemtable.base, i);
+        if (!address || !ReadProcessMemory(GetCurrentProcess(), (LPCVOID)address, element, sizeof(element), NULL))
+            continue;
+        addsystem({
+            getint(element, FieldId::System_id),
+            getint(element, FieldId::System_risklevel),
+            getint(element, FieldId::System_faction),
+            getint(element, FieldId::System_mapcoordinatex),
+            getint(element, FieldId::System_mapcoordinatey),
+            getint(element, FieldId::System_mapcoordinatez),
+            getint(element, FieldId::System_jumpgatestationid)
+        });
+    }
+}
+
+void Galaxy::readstations()
+{
+    uint8_t element[ELEMENT_SPAN];
+    const std::vector<unsigned int>& namechain = FieldRegistry::fields[(size_t)FieldId::Station_name].offsets;
+
+    stations = {};
+    for (int i = 0; i < stationtable.size; i++) {
+        uintptr_t address = getelement(stationtable, stationtable.base, i);
+        if (!address || !ReadProcessMemory(GetCurrentProcess(), (LPCVOID)address, element, sizeof(element), NULL))
+            continue;
+        // the name is behind a pointer, same chain as the schema minus the hop to the station struct
+        uintptr_t name = address + namechain[1];
+        if (namechain.size() > 2)
+            name = MemoryUtils::GetPointerAddress(name, std::vector<unsigned int>(namechain.begin() + 2, namechain.end()));
+        addstation({
+            getint(element, FieldId::Station_id),
+            getint(element, FieldId::Station_techlevel),
+            name ? MemoryUtils::ReadWideString(name) : std::string()
+        });
+    }
+}
+
+void Galaxy::addsystem(const SystemInfo& info)
+{
+    systems.id.push_back(info.id);
+    systems.risk.push_back(info.risk);
+    systems.faction.push_back(info.faction);
+    systems.x.push_back(info.x);
+    systems.y.push_back(info.y);
+    systems.z.push_back(info.z);
+    systems.jumpgatestationid.push_back(info.jumpgatestationid);
+}
+
+void Galaxy::addstation(const StationInfo& info)
+{
+    stations.id.push_back(info.id);
+    stations.techlevel.push_back(info.techlevel);
+    stations.name.push_back(info.name);
+}
+
+void Galaxy::refresh()
+{
+    uintptr_t base;
+    int size;
+
+    if (locate(systemtable, base, size) && (base != systemtable.base || size != systemtable.size)) {
+        systemtable.base = base;
+        systemtable.size = size;
+        readsystems();
+        buildindexes();
+        Logger::debug("Galaxy", "System table at {:#x}, {} systems cached", base, systems.id.size());
+    }
+    if (locate(stationtable, base, size) && (base != stationtable.base || size != stationtable.size)) {
+        stationtable.base = base;
+        stationtable.size = size;
+        readstations();
+        buildindexes();
+        Logger::debug("Galaxy", "Station table at {:#x}, {} stations cached", base, stations.id.size());
+    }
+    observe();
+}
+
+void Galaxy::observe()
+{
+    static int lastsystem = 0;
+    static int laststation = 0;
+    bool changed = false;
+
+    if (systemtable.array.empty() && FieldRegistry::isvalid(FieldId::System_id) && FieldRegistry::cached(FieldId::System_id) != lastsystem) {
+        SystemInfo info = {
+            FieldRegistry::cached(FieldId::System_id),
+            FieldRegistry::cached(FieldId::System_risklevel),
+            FieldRegistry::cached(FieldId::System_faction),
+            FieldRegistry::cached(FieldId::System_mapcoordinatex),
+            FieldRegistry::cached(FieldId::System_mapcoordinatey),
+            FieldRegistry::cached(FieldId::System_mapcoordinatez),
+            FieldRegistry::cached(FieldId::System_jumpgatestationid)
+        };
+        uint32_t index;
+        lastsystem = info.id;
+        if (!findsystem(info.id, index)) {
+            addsystem(info);
+            changed = true;
+        }
+    }
+    if (stationtable.array.empty() && FieldRegistry::isvalid(FieldId::Station_id) && FieldRegistry::cached(FieldId::Station_id) != laststation) {
+        int id = FieldRegistry::cached(FieldId::Station_id);
+        laststation = id;
+        if (std::find(stations.id.begin(), stations.id.end(), id) == stations.id.end()) {
+            addstation({ id, FieldRegistry::cached(FieldId::Station_techlevel), Station::getname() });
+            changed = true;
+        }
+    }
+    if (changed)
+        buildindexes();
+}
+
+void Galaxy::buildkdtree(size_t begin, size_t end, int depth)
+{
+    if (end - begin <= 1)
+        return;
+    size_t middle = begin + (end - begin) / 2;
+    const std::vector<int>& axis = depth % 3 == 0 ? systems.x : depth % 3 == 1 ? systems.y : systems.z;
+
+    std::nth_element(kdtree.begin() + begin, kdtree.begin() + middle, kdtree.begin() + end, [&axis](uint32_t a, uint32_t b) {
+        return axis[a] < axis[b];
+    });
+    buildkdtree(begin, middle, depth + 1);
+    buildkdtree(middle + 1, end, depth + 1);
+}
+
+void Galaxy::buildindexes()
+{
+    kdtree.resize(systems.id.size());
+    for (uint32_t i = 0; i < kdtree.size(); i++)
+        kdtree[i] = i;
+    buildkdtree(0, kdtree.size(), 0);
+
+    bytechlevel.resize(stations.id.size());
+    for (uint32_t i = 0; i < bytechlevel.size(); i++)
+        bytechlevel[i] = i;
+    std::stable_sort(bytechlevel.begin(), bytechlevel.end(), [](uint32_t a, uint32_t b) {
+        return stations.techlevel[a] < stations.techlevel[b];
+    });
+}
+
+int64_t Galaxy::getdistance(uint32_t index, int x, int y, int z)
+{
+    int64_t dx = (int64_t)systems.x[index] - x;
+    int64_t dy = (int64_t)systems.y[index] - y;
+    int64_t dz = (int64_t)systems.z[index] - z;
+
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// heap is a max heap on the distance holding the best candidates so far
+void Galaxy::searchnearest(size_t begin, size_t end, int depth, int x, int y, int z, size_t count, std::vector<std::pair<int64_t, uint32_t>>& heap)
+{
+    if (begin >= end)
+        return;
+    size_t middle = begin + (end - begin) / 2;
+    uint32_t node = kdtree[middle];
+    int64_t distance = getdistance(node, x, y, z);
+
+    if (heap.size() < count || distance < heap.front().first) {
+        heap.push_back({ distance, node });
+        std::push_heap(heap.begin(), heap.end());
+        if (heap.size() > count) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.pop_back();
+        }
+    }
+
+    int target = depth % 3 == 0 ? x : depth % 3 == 1 ? y : z;
+    int split = depth % 3 == 0 ? systems.x[node] : depth % 3 == 1 ? systems.y[node] : systems.z[node];
+    int64_t delta = (int64_t)target - split;
+    bool left = delta < 0;
+
+    searchnearest(left ? begin : middle + 1, left ? middle : end, depth + 1, x, y, z, count, heap);
+    if (heap.size() < count || delta * delta < heap.front().first)
+        searchnearest(left ? middle + 1 : begin, left ? end : middle, depth + 1, x, y, z, count, heap);
+}
+
+void Galaxy::searchradius(size_t begin, size_t end, int depth, int x, int y, int z, int64_t radius, std::vector<uint32_t>& out)
+{
+    if (begin >= end)
+        return;
+    size_t middle = begin + (end - begin) / 2;
+    uint32_t node = kdtree[middle];
+
+    if (getdistance(node, x, y, z) <= radius * radius)
+        out.push_back(node);
+
+    int target = depth % 3 == 0 ? x : depth % 3 == 1 ? y : z;
+    int split = depth % 3 == 0 ? systems.x[node] : depth % 3 == 1 ? systems.y[node] : systems.z[node];
+    int64_t delta = (int64_t)target - split;
+
+    if (delta - radius <= 0)
+        searchradius(begin, middle, depth + 1, x, y, z, radius, out);
+    if (delta + radius >= 0)
+        searchradius(middle + 1, end, depth + 1, x, y, z, radius, out);
+}
+
+size_t Galaxy::systemcount()
+{
+    return systems.id.size();
+}
+
+size_t Galaxy::stationcount()
+{
+    return stations.id.size();
+}
+
+Galaxy::SystemInfo Galaxy::getsystem(uint32_t index)
+{
+    return {
+        systems.id[index],
+        systems.risk[index],
+        systems.faction[index],
+        systems.x[index],
+        systems.y[index],
+        systems.z[index],
+        systems.jumpgatestationid[index]
+    };
+}
+
+Galaxy::StationInfo Galaxy::getstation(uint32_t index)
+{
+    return { stations.id[index], stations.techlevel[index], stations.name[index] };
+}
+
+bool Galaxy::findsystem(int id, uint32_t& index)
+{
+    auto it = std::find(systems.id.begin(), systems.id.end(), id);
+
+    if (it == systems.id.end())
+        return false;
+    index = (uint32_t)(it - systems.id.begin());
+    return true;
+}
+
+void Galaxy::nearest(int x, int y, int z, size_t count, std::vector<uint32_t>& out)
+{
+    std::vector<std::pair<int64_t, uint32_t>> heap;
+
+    if (count == 0)
+        return;
+    heap.reserve(count + 1);
+    searchnearest(0, kdtree.size(), 0, x, y, z, count, heap);
+    std::sort_heap(heap.begin(), heap.end());
+    for (const auto& candidate : heap)
+        out.push_back(candidate.second);
+}
+
+void Galaxy::withinradius(int x, int y, int z, int64_t radius, std::vector<uint32_t>& out)
+{
+    if (radius >= 0)
+        searchradius(0, kdtree.size(), 0, x, y, z, radius, out);
+}
+
+void Galaxy::stationsbytechlevel(int min, int max, std::vector<uint32_t>& out)
+{
+    auto first = std::lower_bound(bytechlevel.begin(), bytechlevel.end(), min, [](uint32_t index, int level) {
+        return stations.techlevel[index] < level;
+    });
+
+    for (auto it = first; it != bytechlevel.end() && stations.techlevel[*it] <= max; ++it)
+        out.push_back(*it);
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+void GamePhase::init()
+{
+    modulebase = MemoryUtils::GetModuleBase("GoF2.exe");
+    ingameprobe = Config::getoffsets("phase.ingame_probe");
+    dockedprobe = Config::getoffsets("phase.docked_probe");
+    heuristic = Config::getbool("phase.heuristic", true);
+    if (ingameprobe.empty() && heuristic)
+        Logger::info("GamePhase", "phase.ingame_probe isn't set, guessing the phase from the mission id (OnExitToMenu may be missed)");
+    else if (ingameprobe.empty())
+        Logger::warning("GamePhase", "phase.ingame_probe isn't set and phase.heuristic is off, the game is never seen as started");
+    else if (dockedprobe.empty() && !heuristic)
+        Logger::warning("GamePhase", "phase.docked_probe isn't set and phase.heuristic is off, docking is never seen");
+}
+
+// Same chains as the galaxy tables: first offset from GoF2.exe, the others followed like the schema ones
+bool GamePhase::probe(const std::vector<unsigned int>& chain, bool& value)
+{
+    if (chain.empty() || modulebase == 0)
+        return false;
+    uintptr_t address = MemoryUtils::GetPointerAddress(modulebase + chain[0], std::vector<unsigned int>(chain.begin() + 1, chain.end()));
+    value = address != 0 && MemoryUtils::Read<int>(address) != 0;
+    return true;
+}
+
+Phase GamePhase::detect()
+{
+    bool ingame;
+    bool docked;
+
+    // the game object isn't there yet (or anymore)
+    if (!FieldRegistry::isvalid(FieldId::Player_money))
+        return Phase::Loading;
+    if (!probe(ingameprobe, ingame)) {
+        // <1000 because when the game init the pointer it has some random values
+        int missionid = FieldRegistry::cached(FieldId::Mission_id);
+        ingame = heuristic && FieldRegistry::isvalid(FieldId::System_id) && missionid > 0 && missionid < 1000;
+    }
+    if (!ingame)
+        return Phase::MainMenu;
+    if (!probe(dockedprobe, docked))
+        docked = heuristic && FieldRegistry::isvalid(FieldId::Station_id);
+    return docked ? Phase::Docked : Phase::InSpace;
+}
+
+bool GamePhase::update(Phase& previous)
+{
+    Phase detected = detect();
+
+    if (detected != candidate) {
+        candidate = detected;
+        stableticks = 0;
+    }
+    if (candidate == current || ++stableticks < STABLE_TICKS)
+        return false;
+    previous = current;
+    current = candidate;
+    Logger::debug("GamePhase", "{} -> {}", getname(previous), getname(current));
+    return true;
+}
+
+Phase GamePhase::get()
+{
+    return current;
+}
+
+const char* GamePhase::getname(Phase phase)
+{
+    switch (phase) {
+    case Phase::Loading:
+        return "loading";
+    case Phase::MainMenu:
+        return "mainmenu";
+    case Phase::InSpace:
+        return "inspace";
+    case Phase::Docked:
+        return "docked";
+    }
+    return "unknown";
+}
+
+bool GamePhase::isingame(Phase phase)
+{
+    return phase == Phase::InSpace || phase == Phase::Docked;
+}
\ No newline at end of file
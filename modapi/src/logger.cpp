@@ -0,0 +1,246 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+Logger::Slot Logger::slots[Logger::SLOT_COUNT];
+
+static const char* levelprefix(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Debug:
+        return "[.]";
+    case LogLevel::Info:
+        return "[*]";
+    case LogLevel::Warning:
+        return "[!]";
+    default:
+        return "[-]";
+    }
+}
+
+void Logger::start()
+{
+    if (running.exchange(true))
+        return;
+    for (size_t i = 0; i < SLOT_COUNT; i++)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    head.store(0, std::memory_order_relaxed);
+    tail = 0;
+    writer = std::thread(writerloop);
+}
+
+void Logger::stop()
+{
+    if (!running.exchange(false))
+        return;
+    if (writer.joinable())
+        writer.join();
+    if (logfile) {
+        fclose(logfile);
+        logfile = nullptr;
+    }
+}
+
+void Logger::setlevel(LogLevel level)
+{
+    minlevel.store((int)level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::parselevel(const std::string& name, LogLevel fallback)
+{
+    if (name == "debug")
+        return LogLevel::Debug;
+    if (name == "info")
+        return LogLevel::Info;
+    if (name == "warning")
+        return LogLevel::Warning;
+    if (name == "error")
+        return LogLevel::Error;
+    return fallback;
+}
+
+bool Logger::enabled(LogLevel level)
+{
+    return (int)level >= minlevel.load(std::memory_order_relaxed);
+}
+
+// Must be called before start(), the file is only touched by the writer thread afterwards
+void Logger::setfile(const std::string& filepath, size_t maxsize, int maxfiles)
+{
+    logpath = filepath;
+    maxlogsize = maxsize;
+    maxlogfiles = maxfiles;
+    logfile = fopen(filepath.c_str(), "ab");
+    if (!logfile)
+        return;
+    fseek(logfile, 0, SEEK_END);
+    logsize = (size_t)ftell(logfile);
+}
+
+// Must be called before start(), stdout isn't usable when the proxy didn't open a console
+void Logger::setconsole(bool enabled)
+{
+    console = enabled;
+}
+
+// Multi producer ring (Vyukov's bounded queue), the writer thread is the only consumer
+void Logger::write(LogLevel level, std::string_view tag, std::string_view text)
+{
+    if (!enabled(level))
+        return;
+    if (!running.load(std::memory_order_relaxed)) {
+        if (console)
+            std::cout << levelprefix(level) << "[" << tag << "] " << text << std::endl;
+        else if (logfile)
+            fprintf(logfile, "%s[%.*s] %.*s\n", levelprefix(level), (int)tag.size(), tag.data(), (int)text.size(), text.data());
+        return;
+    }
+
+    size_t pos = head.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & (SLOT_COUNT - 1)];
+        intptr_t diff = (intptr_t)slot->sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t taglength = (std::min)(tag.size(), TAG_SIZE - 1);
+    memcpy(slot->tag, tag.data(), taglength);
+    slot->tag[taglength] = '\0';
+    slot->length = (uint16_t)(std::min)(text.size(), TEXT_SIZE);
+    memcpy(slot->text, text.data(), slot->length);
+    slot->level = level;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+uint64_t Logger::getdropped()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+bool Logger::drain()
+{
+    bool wrote = false;
+
+    while (true) {
+        Slot& slot = slots[tail & (SLOT_COUNT - 1)];
+
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+            break;
+        output(slot);
+        slot.sequence.store(tail + SLOT_COUNT, std::memory_order_release);
+        tail++;
+        wrote = true;
+    }
+    return wrote;
+}
+
+void Logger::output(const Slot& slot)
+{
+    char line[TAG_SIZE + TEXT_SIZE + 16];
+    int length = snprintf(line, sizeof(line), "%s[%s] %.*s\n", levelprefix(slot.level), slot.tag, (int)slot.length, slot.text);
+
+    if (length <= 0)
+        return;
+    length = (std::min)(length, (int)sizeof(line) - 1);
+    if (console)
+        fwrite(line, 1, length, stdout);
+    if (logfile) {
+        fwrite(line, 1, length, logfile);
+        logsize += length;
+        if (maxlogsize > 0 && logsize >= maxlogsize)
+            rotate();
+    }
+}
+
+// modapi.log -> modapi.log.1 -> ... -> modapi.log.<maxlogfiles>, the oldest one is dropped
+void Logger::rotate()
+{
+    fclose(logfile);
+    logfile = nullptr;
+    if (maxlogfiles > 0) {
+        std::error_code ec;
+        std::filesystem::remove(logpath + "." + std::to_string(maxlogfiles), ec);
+        for (int i = maxlogfiles - 1; i >= 1; i--)
+            std::filesystem::rename(logpath + "." + std::to_string(i), logpath + "." + std::to_string(i + 1), ec);
+        std::filesystem::rename(logpath, logpath + ".1", ec);
+    }
+    logfile = fopen(logpath.c_str(), "wb");
+    logsize = 0;
+}
+
+void Logger::writerloop()
+{
+    uint64_t reported = 0;
+
+    while (running.load(std::memory_order_relaxed)) {
+        bool wrote = drain();
+        uint64_t lost = dropped.load(std::memory_order_relaxed);
+
+        if (lost != reported) {
+            Slot notice;
+            int length = snprintf(notice.text, sizeof(notice.text), "%llu log lines dropped (ring full)", (unsigned long long)(lost - reported));
+            snprintf(notice.tag, sizeof(notice.tag), "Logger");
+            notice.level = LogLevel::Warning;
+            notice.length = (uint16_t)length;
+            output(notice);
+            reported = lost;
+            wrote = true;
+        }
+        if (wrote) {
+            if (console)
+                fflush(stdout);
+            if (logfile)
+                fflush(logfile);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    drain();
+    if (console)
+        fflush(stdout);
+}
\ No newline at end of file
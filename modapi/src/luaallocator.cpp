@@ -0,0 +1,294 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+LuaAllocator::Stats LuaAllocator::stats[LuaAllocator::MAX_MODS];
+
+static size_t getsizeclass(size_t size)
+{
+    return (size + LuaAllocator::GRANULARITY - 1) / LuaAllocator::GRANULARITY - 1;
+}
+
+size_t LuaAllocator::getowner()
+{
+    size_t owner = (size_t)ModContext::getcurrent();
+
+    return owner < MAX_MODS ? owner : 0;
+}
+
+// The sampler thread gives Sample buffers back (uncharge) while the tick thread allocates, so used only moves through atomic read-modify-writes
+bool LuaAllocator::reserve(size_t owner, size_t size)
+{
+    Stats& stat = stats[owner];
+    size_t limit = stat.limit.load(std::memory_order_relaxed);
+    size_t current = stat.used.load(std::memory_order_relaxed);
+    size_t used;
+
+    do {
+        used = current + size;
+        if (limit != 0 && used > limit) {
+            // a mod stuck at its limit fails every tick, don't flood the log with it
+            if (stat.failures.fetch_add(1, std::memory_order_relaxed) % 1000 == 0)
+                Logger::warning(ModContext::getname((int)owner), "Lua memory limit reached ({} KB)", limit / 1024);
+            return false;
+        }
+    } while (!stat.used.compare_exchange_weak(current, used, std::memory_order_relaxed));
+    size_t peak = stat.peak.load(std::memory_order_relaxed);
+    while (used > peak && !stat.peak.compare_exchange_weak(peak, used, std::memory_order_relaxed))
+        ;
+    stat.allocations.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void LuaAllocator::release(size_t owner, size_t size)
+{
+    stats[owner].used.fetch_sub(size, std::memory_order_relaxed);
+}
+
+LuaAllocator::Page* LuaAllocator::newpage(size_t owner, size_t sizeclass)
+{
+    Page* page = freepages;
+
+    if (page) {
+        freepages = page->next;
+    } else {
+        if (arenacursor == arenaend) {
+            arenacursor = (uint8_t*)VirtualAlloc(NULL, ARENA_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            if (!arenacursor) {
+                arenaend = nullptr;
+                return nullptr;
+            }
+            arenaend = arenacursor + ARENA_SIZE;
+            reserved.fetch_add(ARENA_SIZE, std::memory_order_relaxed);
+        }
+        page = (Page*)arenacursor;
+        arenacursor += PAGE_SIZE;
+    }
+
+    size_t blocksize = (sizeclass + 1) * GRANULARITY;
+    page->prev = nullptr;
+    page->next = nullptr;
+    page->freelist = nullptr;
+    page->bump = (uint8_t*)page + sizeof(Page);
+    page->owner = (uint16_t)owner;
+    page->sizeclass = (uint16_t)sizeclass;
+    page->live = 0;
+    page->capacity = (uint16_t)((PAGE_SIZE - sizeof(Page)) / blocksize);
+    return page;
+}
+
+void* LuaAllocator::allocsmall(size_t owner, size_t size)
+{
+    size_t sizeclass = getsizeclass(size);
+    Page* page = partial[owner][sizeclass];
+    void* block;
+
+    if (!page) {
+        page = newpage(owner, sizeclass);
+        if (!page)
+            return nullptr;
+        partial[owner][sizeclass] = page;
+    }
+    if (page->freelist) {
+        block = page->freelist;
+        page->freelist = page->freelist->next;
+    } else {
+        block = page->bump;
+        page->bump += (sizeclass + 1) * GRANULARITY;
+    }
+    // a full page leaves the partial list until one of its blocks is freed
+    if (++page->live == page->capacity) {
+        partial[owner][sizeclass] = page->next;
+        if (page->next)
+            page->next->prev = nullptr;
+        page->next = nullptr;
+    }
+    return block;
+}
+
+void LuaAllocator::freesmall(void* ptr)
+{
+    Page* page = (Page*)((uintptr_t)ptr & ~(uintptr_t)(PAGE_SIZE - 1));
+    Page*& head = partial[page->owner][page->sizeclass];
+    FreeBlock* block = (FreeBlock*)ptr;
+
+    if (page->live == page->capacity) {
+        page->prev = nullptr;
+        page->next = head;
+        if (head)
+            head->prev = page;
+        head = page;
+    }
+    block->next = page->freelist;
+    page->freelist = block;
+    // empty pages go back to the shared pool so any mod or size class can reuse them
+    if (--page->live == 0) {
+        if (page->prev)
+            page->prev->next = page->next;
+        else
+            head = page->next;
+        if (page->next)
+            page->next->prev = page->prev;
+        page->next = freepages;
+        freepages = page;
+    }
+}
+
+void* LuaAllocator::alloclarge(size_t owner, size_t size)
+{
+    LargeHeader* header = (LargeHeader*)malloc(sizeof(LargeHeader) + size);
+
+    if (!header)
+        return nullptr;
+    header->owner = (uint32_t)owner;
+    return header + 1;
+}
+
+void LuaAllocator::freelarge(void* ptr)
+{
+    LargeHeader* header = (LargeHeader*)ptr - 1;
+
+    if (isdemoted(ptr)) {
+        if (header->prev)
+            header->prev->next = header->next;
+        else
+            demoted = header->next;
+        if (header->next)
+            header->next->prev = header->prev;
+    }
+    free(header);
+}
+
+// The list only fills up when the memory ran out, it is empty (and skipped) otherwise
+bool LuaAllocator::isdemoted(void* ptr)
+{
+    for (LargeHeader* header = demoted; header; header = header->next) {
+        if (header + 1 == ptr)
+            return true;
+    }
+    return false;
+}
+
+void* LuaAllocator::alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    // when ptr is NULL osize is the lua type tag of the new object, not a size
+    size_t oldsize = ptr ? osize : 0;
+    size_t oldowner = 0;
+    bool large = ptr && (oldsize > MAX_SMALL || isdemoted(ptr));
+
+    if (ptr)
+        oldowner = large ? ((LargeHeader*)ptr - 1)->owner : ((Page*)((uintptr_t)ptr & ~(uintptr_t)(PAGE_SIZE - 1)))->owner;
+
+    if (nsize == 0) {
+        if (ptr) {
+            release(oldowner, oldsize);
+            if (large)
+                freelarge(ptr);
+            else
+                freesmall(ptr);
+        }
+        return nullptr;
+    }
+    if (ptr && !large && nsize <= MAX_SMALL && getsizeclass(oldsize) == getsizeclass(nsize)) {
+        stats[oldowner].used.fetch_add(nsize - oldsize, std::memory_order_relaxed);
+        return ptr;
+    }
+
+    // lua expects shrinking to always succeed, so a shrink stays with the old owner and only growth is checked against the limit
+    size_t owner = ptr && nsize <= oldsize ? oldowner : getowner();
+    if (nsize > oldsize) {
+        if (!reserve(owner, nsize))
+            return nullptr;
+    } else {
+        stats[owner].used.fetch_add(nsize, std::memory_order_relaxed);
+    }
+
+    void* block = nsize <= MAX_SMALL ? allocsmall(owner, nsize) : alloclarge(owner, nsize);
+    if (!block && ptr && nsize <= oldsize) {
+        // out of memory: the old block is big enough, keep it
+        release(oldowner, oldsize);
+        if (large && nsize <= MAX_SMALL && !isdemoted(ptr)) {
+            LargeHeader* header = (LargeHeader*)ptr - 1;
+            header->prev = nullptr;
+            header->next = demoted;
+            if (demoted)
+                demoted->prev = header;
+            demoted = header;
+        }
+        return ptr;
+    }
+    if (!block) {
+        release(owner, nsize);
+        return nullptr;
+    }
+    if (ptr) {
+        memcpy(block, ptr, oldsize < nsize ? oldsize : nsize);
+        release(oldowner, oldsize);
+        if (large)
+            freelarge(ptr);
+        else
+            freesmall(ptr);
+    }
+    return block;
+}
+
+void LuaAllocator::setlimit(int mod, size_t bytes)
+{
+    if (mod >= 0 && mod < (int)MAX_MODS)
+        stats[mod].limit.store(bytes, std::memory_order_relaxed);
+}
+
+bool LuaAllocator::charge(int mod, size_t bytes)
+{
+    return mod >= 0 && mod < (int)MAX_MODS && reserve((size_t)mod, bytes);
+}
+
+void LuaAllocator::uncharge(int mod, size_t bytes)
+{
+    if (mod >= 0 && mod < (int)MAX_MODS)
+        release((size_t)mod, bytes);
+}
+
+const LuaAllocator::Stats& LuaAllocator::getstats(int mod)
+{
+    return stats[mod >= 0 && mod < (int)MAX_MODS ? mod : 0];
+}
+
+size_t LuaAllocator::getreserved()
+{
+    return reserved.load(std::memory_order_relaxed);
+}
\ No newline at end of file
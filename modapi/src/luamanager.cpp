@@ -8,79 +8,694 @@
 #include <sol/sol.hpp>
 #include <map>
 #include <string>
+#include <cmath>
 #include "modapi_utils.h"
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
 #include <Game/mission.h>
 #include <Game/asset.h>
+#include "timers.h"
+#include "sharedstore.h"
+#include "fileio.h"
+
+template <typename T>
+static sol::object getbuffervalue(lua_State* L, const MemoryBuffer& buffer, size_t offset)
+{
+    T value;
+
+    if (!buffer.get(offset, value))
+        return sol::lua_nil;
+    return sol::make_object(L, value);
+}
+
+// Lua side of ReadFileAsync & co, raw functions because they may have to yield.
+// With a callback (last argument) they return true at once and the callback gets (result, error) on a later tick,
+// without one they suspend the calling coroutine until the result is there and return (result, error).
+static int queuefilejob(lua_State* L, FileOperation operation)
+{
+    int callbackindex = operation == FileOperation::Write || operation == FileOperation::Append ? 3 : 2;
+    size_t size = 0;
+    const char* path = lua_tostring(L, 1);
+    const char* data = callbackindex == 3 ? lua_tolstring(L, 2, &size) : "";
+    const char* failure = nullptr;
+    bool waiting = !lua_isfunction(L, callbackindex);
+
+    // lua_yield doesn't return, nothing with a destructor may be alive when it's called
+    {
+        FileIO::Waiter waiter;
+        waiter.listener.mod = ModContext::getcurrent();
+        if (!waiting) {
+            waiter.listener.callback = sol::main_protected_function(L, callbackindex);
+        } else if (lua_isyieldable(L)) {
+            lua_pushthread(L);
+            waiter.thread = sol::thread(L, -1);
+            lua_pop(L, 1);
+        } else {
+            Logger::warning(ModContext::getname(waiter.listener.mod), "File functions need a callback when they aren't called from a coroutine");
+            failure = "no callback";
+        }
+        if (!failure && (!path || !data || !FileIO::queue(operation, path, data, size, std::move(waiter))))
+            failure = "invalid path";
+    }
+    if (failure) {
+        lua_pushnil(L);
+        lua_pushstring(L, failure);
+        return 2;
+    }
+    if (waiting)
+        return lua_yield(L, 0);
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int readfileasync(lua_State* L)
+{
+    return queuefilejob(L, FileOperation::Read);
+}
+
+static int writefileasync(lua_State* L)
+{
+    return queuefilejob(L, FileOperation::Write);
+}
+
+static int appendfileasync(lua_State* L)
+{
+    return queuefilejob(L, FileOperation::Append);
+}
+
+static int listdirectoryasync(lua_State* L)
+{
+    return queuefilejob(L, FileOperation::List);
+}
 
 void LuaManager::init()
 {
     lua_state.open_libraries(sol::lib::base, sol::lib::package, sol::lib::string, sol::lib::math);
+    gcstepkb = (std::max)(Config::getint("lua.gc_step_kb", 16), 1);
+    gcbudget = std::chrono::microseconds(Config::getint("lua.gc_budget_us", 2000));
+    Watchdog::init();
+    lua_gc(lua_state.lua_state(), LUA_GCSTOP, 0);
+}
+
+void LuaManager::requestfullgc()
+{
+    fullgcrequested = true;
+}
+
+// Runs at the end of a tick with whatever time is left before the next one.
+// Full collections only happen on natural pauses (menu, system change) or when memory doubled since the last one.
+void LuaManager::collectgarbage(std::chrono::steady_clock::time_point deadline)
+{
+    lua_State* L = lua_state.lua_state();
+    auto start = std::chrono::steady_clock::now();
+    size_t memory = (size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+
+    if (!fullgcrequested && gcbaseline > 0 && memory > (std::max)(gcbaseline * 2, (size_t)4 * 1024 * 1024)) {
+        Logger::debug("LuaManager", "Lua memory doubled since the last full collection ({} KB), collecting now", memory / 1024);
+        fullgcrequested = true;
+    }
+
+    if (fullgcrequested) {
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        fullgcrequested = false;
+        gcbaseline = (size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+        gcstats.lastpause = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        gcstats.lastfullpause = gcstats.lastpause;
+        gcstats.fullcollections++;
+        Logger::debug("LuaManager", "Full lua collection took {} us, {} KB left", gcstats.lastpause, gcbaseline / 1024);
+    } else {
+        auto stop = (std::min)(deadline, start + gcbudget);
+        auto now = start;
+
+        // always do at least one step so the collector keeps up even when the mods eat the whole tick
+        do {
+            gcstats.steps++;
+            if (lua_gc(L, LUA_GCSTEP, gcstepkb)) {
+                if (gcbaseline == 0)
+                    gcbaseline = (size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+                break;
+            }
+            now = std::chrono::steady_clock::now();
+        } while (now < stop);
+        gcstats.lastpause = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    gcstats.maxpause = (std::max)(gcstats.maxpause, gcstats.lastpause);
 }
 
 void LuaManager::bind_api()
 {
 
     //lua_state.set_function("HelloWorld", &HelloWorld);
+
+    // print goes through the logger so a mod printing every tick doesn't stall the tick on the console
+    lua_state.set_function("print", [](sol::this_state ts, sol::variadic_args args) {
+        lua_State* L = ts;
+        std::string line;
+
+        for (int i = 0; i < (int)args.size(); i++) {
+            size_t length;
+            const char* str = luaL_tolstring(L, args.stack_index() + i, &length);
+            if (i > 0)
+                line += '\t';
+            line.append(str, length);
+            lua_pop(L, 1);
+        }
+        Logger::info(ModContext::getname(ModContext::getcurrent()), "{}", line);
+    });
     
-    // TODO: do a better wait because if a script uses wait() then every scripts waits...
+    // wait() blocks every mod, use SetTimeout/SetInterval instead
     lua_state.set_function("wait", [](int seconds) { 
-        Sleep(seconds * 1000); 
+        DWORD milliseconds = seconds * 1000;
+        int64_t remaining = Watchdog::remaining().count();
+
+        // inside a callback the sleep can't go past the callback budget, it would stall the whole tick
+        if (remaining < (int64_t)milliseconds) {
+            Logger::warning(ModContext::getname(ModContext::getcurrent()), "wait({}) inside a callback cut to {} ms, use SetTimeout instead", seconds, remaining);
+            milliseconds = (DWORD)remaining;
+        }
+        Sleep(milliseconds); 
     });
 
-    lua_state.new_usertype<Player>("Player",
+    sol::usertype<Player> Player_type = lua_state.new_usertype<Player>("Player",
         sol::no_constructor,
-        "money", sol::property(&Player::getmoney, &Player::setmoney),
-        "cargo", sol::property(&Player::getcargo, &Player::setcargo),
-        "maxcargo", sol::property(&Player::getmaxcargo, &Player::setmaxcargo),
-        "armor", sol::property(&Player::getshiparmor, &Player::setshiparmor),
-        "maxhealth", sol::property(&Player::getmaxshiphealth, &Player::setmaxshiphealth),
-        "enemieskilled", sol::property(&Player::getenemieskilled, &Player::setenemieskilled),
-        "level", sol::property(&Player::getlevel, &Player::setlevel),
-        "visitedstations", sol::property(&Player::getvisitedstations, &Player::setvisitedstations),
-        "jumpgateusedcount", sol::property(&Player::getjumpgateusedcount, &Player::setjumpgateusedcount),
-        "cargotookcount", sol::property(&Player::getcargotookcount, &Player::setcargotookcount),
         "HasShipArmor", [](Player& self) -> bool {
             return Player::hasshiparmor();
         }
     );
+    sol::usertype<System> System_type = lua_state.new_usertype<System>("System", sol::no_constructor);
+    sol::usertype<Mission> Mission_type = lua_state.new_usertype<Mission>("Mission", sol::no_constructor);
+    sol::usertype<Station> Station_type = lua_state.new_usertype<Station>("Station", sol::no_constructor);
+    MODAPI_FIELDS(MODAPI_FIELD_BIND)
 
-    lua_state.new_usertype<System>("System",
+    lua_state.new_usertype<Asset>("Asset",
         sol::no_constructor,
-        "id", sol::property(&System::getid, &System::setid),
-        "risk", sol::property(&System::getrisklevel, &System::setrisklevel),
-        "faction", sol::property(&System::getfaction, &System::setfaction),
-        "jumpgatestationid", sol::property(&System::getjumpgatestationid, &System::setjumpgatestationid),
-        "mapcoordinate_x", sol::property(&System::getmapcoordinatex, &System::setmapcoordinatex),
-        "mapcoordinate_y", sol::property(&System::getmapcoordinatey, &System::setmapcoordinatey),
-        "mapcoordinate_z", sol::property(&System::getmapcoordinatez, &System::setmapcoordinatez)
+        "GetAssetFilePath", [](Asset& self, unsigned int offset) -> std::string {
+            return Asset::getassetfilepath(offset);
+        },
+        "SetAssetFilePath", [](Asset& self, unsigned int offset, const std::string filepath) {
+            Asset::setassetfilepath(offset, filepath);
+        }
     );
 
-    lua_state.new_usertype<Mission>("Mission",
-        sol::no_constructor,
-        "id", sol::property(&Mission::getid, &Mission::setid),
-        "completedsidemissions", sol::property(&Mission::getcompletedsidemissions, &Mission::setcompletedsidemission)
+    lua_state.set_function("Pin", [](const std::string& name, int value) -> bool {
+        FieldId id = FieldRegistry::find(name);
+
+        if (id == FieldId::Count || !FieldRegistry::pin(id, value, ModContext::getcurrent())) {
+            Logger::warning(ModContext::getname(ModContext::getcurrent()), "Pin('{}'): not a writable int field", name);
+            return false;
+        }
+        return true;
+    });
+
+    lua_state.set_function("Unpin", [](const std::string& name) -> bool {
+        FieldId id = FieldRegistry::find(name);
+
+        return id != FieldId::Count && FieldRegistry::unpin(id, ModContext::getcurrent());
+    });
+
+    // First/Next block the mod thread for the whole scan, callbacks should use the Async versions (the callback gets the result count)
+    auto runscan = [](bool first, const std::string& comparename, sol::object value, sol::optional<double> high) -> sol::optional<std::function<bool(MemoryScanner&)>> {
+        ScanCompare compare;
+        std::string text = value.is<std::string>() ? value.as<std::string>() : std::string();
+        double low = value.is<double>() ? value.as<double>() : 0.0;
+        double upper = high.value_or(low);
+
+        if (!MemoryScanner::parsecompare(comparename, compare))
+            return sol::nullopt;
+        return std::function<bool(MemoryScanner&)>([first, compare, low, upper, text](MemoryScanner& scanner) {
+            return first ? scanner.first(compare, low, upper, text) : scanner.next(compare, low, upper, text);
+        });
+    };
+    auto startscan = [runscan](MemoryScanner& self, bool first, const std::string& compare, sol::object value, sol::optional<double> high, sol::protected_function callback) -> bool {
+        auto scan = runscan(first, compare, value, high);
+        EventManager::Listener listener = { ModContext::getcurrent(), callback };
+
+        return scan && self.start(*scan, [listener](size_t count) mutable {
+            EventManager::call(listener, "scan", "Scanner", count);
+        });
+    };
+
+    lua_state.new_usertype<MemoryScanner>("Scanner",
+        sol::factories([](const std::string& type) -> std::unique_ptr<MemoryScanner> {
+            ScanType scantype;
+
+            if (!MemoryScanner::parsetype(type, scantype)) {
+                Logger::warning(ModContext::getname(ModContext::getcurrent()), "Scanner.new('{}'): type must be int, float, string or utf16", type);
+                scantype = ScanType::Int;
+            }
+            return std::make_unique<MemoryScanner>(scantype);
+        }),
+        "First", [runscan](MemoryScanner& self, const std::string& compare, sol::object value, sol::optional<double> high) -> sol::optional<size_t> {
+            auto scan = runscan(true, compare, value, high);
+
+            if (self.isbusy() || !scan || !(*scan)(self))
+                return sol::nullopt;
+            return self.count();
+        },
+        "Next", [runscan](MemoryScanner& self, const std::string& compare, sol::object value, sol::optional<double> high) -> sol::optional<size_t> {
+            auto scan = runscan(false, compare, value, high);
+
+            if (self.isbusy() || !scan || !(*scan)(self))
+                return sol::nullopt;
+            return self.count();
+        },
+        "FirstAsync", [startscan](MemoryScanner& self, const std::string& compare, sol::object value, sol::object high, sol::protected_function callback) -> bool {
+            return startscan(self, true, compare, value, high.is<double>() ? sol::optional<double>(high.as<double>()) : sol::nullopt, callback);
+        },
+        "NextAsync", [startscan](MemoryScanner& self, const std::string& compare, sol::object value, sol::object high, sol::protected_function callback) -> bool {
+            return startscan(self, false, compare, value, high.is<double>() ? sol::optional<double>(high.as<double>()) : sol::nullopt, callback);
+        },
+        "Count", [](MemoryScanner& self) -> size_t {
+            return self.isbusy() ? 0 : self.count();
+        },
+        "IsBusy", &MemoryScanner::isbusy,
+        "IsTruncated", &MemoryScanner::istruncated,
+        "Results", [](MemoryScanner& self, sol::this_state ts, sol::optional<size_t> max) -> sol::table {
+            sol::state_view lua(ts);
+            std::vector<uintptr_t> addresses;
+
+            if (!self.isbusy())
+                self.getresults(addresses, max.value_or(1000));
+            sol::table result = lua.create_table((int)addresses.size(), 0);
+            for (size_t i = 0; i < addresses.size(); i++)
+                result[i + 1] = addresses[i];
+            return result;
+        },
+        "Reset", [](MemoryScanner& self) {
+            if (!self.isbusy())
+                self.reset();
+        }
+    );
+
+    // Memory.ReadBuffer copies a whole struct/table in one read. The uppercase Buffer getters take byte offsets, the lowercase ones
+    // an element index, all of them return nil past the end
+    auto buffervalue = [](lua_State* L, const MemoryBuffer& buffer, BufferType type, size_t offset, size_t length) -> sol::object {
+        std::string text;
+
+        switch (type) {
+        case BufferType::U8:
+            return getbuffervalue<uint8_t>(L, buffer, offset);
+        case BufferType::I8:
+            return getbuffervalue<int8_t>(L, buffer, offset);
+        case BufferType::U16:
+            return getbuffervalue<uint16_t>(L, buffer, offset);
+        case BufferType::I16:
+            return getbuffervalue<int16_t>(L, buffer, offset);
+        case BufferType::U32:
+            return getbuffervalue<uint32_t>(L, buffer, offset);
+        case BufferType::I32:
+            return getbuffervalue<int32_t>(L, buffer, offset);
+        case BufferType::F32:
+            return getbuffervalue<float>(L, buffer, offset);
+        case BufferType::F64:
+            return getbuffervalue<double>(L, buffer, offset);
+        case BufferType::Ptr:
+            return getbuffervalue<uintptr_t>(L, buffer, offset);
+        case BufferType::UTF16:
+            if (buffer.getutf16(offset, length, text))
+                return sol::make_object(L, text);
+            break;
+        case BufferType::String:
+            if (buffer.getstring(offset, length, text))
+                return sol::make_object(L, text);
+            break;
+        }
+        return sol::lua_nil;
+    };
+    // the i-th value of a type (0 based, at byte i * type size), what the lowercase getters return
+    auto bufferelement = [buffervalue](lua_State* L, const MemoryBuffer& buffer, BufferType type, size_t index) -> sol::object {
+        size_t typesize = MemoryBuffer::gettypesize(type);
+
+        if (index > buffer.getsize() / typesize)
+            return sol::lua_nil;
+        return buffervalue(L, buffer, type, index * typesize, 0);
+    };
+    auto structtable = [buffervalue](lua_State* L, const MemoryBuffer& buffer, const MemoryBuffer::Layout& layout, size_t offset) -> sol::table {
+        sol::state_view lua(L);
+        sol::table result = lua.create_table(0, (int)layout.fields.size());
+
+        for (const auto& field : layout.fields)
+            result[field.name] = buffervalue(L, buffer, field.type, offset + field.offset, field.length);
+        return result;
+    };
+
+    lua_state.create_named_table("Memory",
+        "ReadBuffer", [](sol::object where, size_t size) -> std::unique_ptr<MemoryBuffer> {
+            auto buffer = std::make_unique<MemoryBuffer>();
+            uintptr_t address = 0;
+
+            if (where.is<sol::table>())
+                address = MemoryBuffer::resolve(where.as<std::vector<unsigned int>>());
+            else if (where.is<uintptr_t>())
+                address = where.as<uintptr_t>();
+            if (!buffer->read(address, size))
+                return nullptr;
+            return buffer;
+        },
+        // Memory.Layout({ id = { "i32", 0x14 }, name = { "utf16", 0x30, 32 } })
+        "Layout", [](sol::table fields) -> sol::optional<MemoryBuffer::Layout> {
+            MemoryBuffer::Layout layout;
+
+            for (const auto& [key, value] : fields) {
+                MemoryBuffer::Field field;
+                sol::optional<sol::table> description = value.as<sol::optional<sol::table>>();
+                sol::optional<std::string> type = description ? (*description)[1].get<sol::optional<std::string>>() : sol::nullopt;
+                if (!key.is<std::string>() || !type || !MemoryBuffer::parsetype(*type, field.type)) {
+                    Logger::warning(ModContext::getname(ModContext::getcurrent()), "Memory.Layout: every field must be name = {{ type, offset [, length] }}");
+                    return sol::nullopt;
+                }
+                field.name = key.as<std::string>();
+                field.offset = (*description)[2].get_or<size_t>(0);
+                field.length = (*description)[3].get_or<size_t>(0);
+                layout.fields.push_back(field);
+            }
+            return layout;
+        }
     );
 
-    lua_state.new_usertype<Station>("Station",
+    lua_state.new_usertype<MemoryBuffer::Layout>("BufferLayout", sol::no_constructor);
+    lua_state.new_usertype<MemoryBuffer>("Buffer",
         sol::no_constructor,
-        "id", sol::property(&Station::getid, &Station::setid),
-        "name", sol::property(&Station::getname, &Station::setname),
-        "level", sol::property(&Station::gettechlevel, &Station::settechlevel)
+        "Size", &MemoryBuffer::getsize,
+        "U8", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::U8, offset, 0); },
+        "I8", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::I8, offset, 0); },
+        "U16", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::U16, offset, 0); },
+        "I16", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::I16, offset, 0); },
+        "U32", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::U32, offset, 0); },
+        "I32", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::I32, offset, 0); },
+        "F32", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::F32, offset, 0); },
+        "F64", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::F64, offset, 0); },
+        "Ptr", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset) { return buffervalue(ts, self, BufferType::Ptr, offset, 0); },
+        "UTF16", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset, size_t length) { return buffervalue(ts, self, BufferType::UTF16, offset, length); },
+        "String", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset, size_t length) { return buffervalue(ts, self, BufferType::String, offset, length); },
+        // buffer:u32(i) -> the i-th u32 of the buffer, for tables of one type
+        "u8", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::U8, index); },
+        "i8", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::I8, index); },
+        "u16", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::U16, index); },
+        "i16", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::I16, index); },
+        "u32", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::U32, index); },
+        "i32", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::I32, index); },
+        "f32", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::F32, index); },
+        "f64", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::F64, index); },
+        "ptr", [bufferelement](MemoryBuffer& self, sol::this_state ts, size_t index) { return bufferelement(ts, self, BufferType::Ptr, index); },
+        // local id, count, speed = buffer:Unpack(0x10, "i32", "u16", "f32") -> values packed back to back from 0x10, like string.unpack
+        "Unpack", [buffervalue](MemoryBuffer& self, sol::this_state ts, size_t offset, sol::variadic_args types) -> sol::variadic_results {
+            sol::variadic_results results;
+            BufferType type;
+
+            for (auto name : types) {
+                if (!name.is<std::string>() || !MemoryBuffer::parsetype(name.get<std::string>(), type) || MemoryBuffer::gettypesize(type) == 0) {
+                    Logger::warning(ModContext::getname(ModContext::getcurrent()), "Buffer:Unpack: only fixed size types (u8 .. f64, ptr)");
+                    results.clear();
+                    break;
+                }
+                results.push_back(buffervalue(ts, self, type, offset, 0));
+                offset += MemoryBuffer::gettypesize(type);
+            }
+            return results;
+        },
+        // buffer:Array("u32", 0, 100) -> the 100 u32 at the start of the buffer, stride defaults to the type size
+        "Array", [buffervalue](MemoryBuffer& self, sol::this_state ts, const std::string& name, size_t offset, size_t count, sol::optional<size_t> stride) -> sol::object {
+            sol::state_view lua(ts);
+            BufferType type;
+
+            if (!MemoryBuffer::parsetype(name, type) || MemoryBuffer::gettypesize(type) == 0)
+                return sol::lua_nil;
+            size_t step = stride.value_or(MemoryBuffer::gettypesize(type));
+            count = (std::min)(count, self.getsize());
+            sol::table result = lua.create_table((int)count, 0);
+            for (size_t i = 0; i < count; i++)
+                result[i + 1] = buffervalue(ts, self, type, offset + i * step, 0);
+            return result;
+        },
+        "Struct", [structtable](MemoryBuffer& self, sol::this_state ts, const MemoryBuffer::Layout& layout, sol::optional<size_t> offset) -> sol::table {
+            return structtable(ts, self, layout, offset.value_or(0));
+        },
+        // one table per element, for arrays of structs (cargo, npc lists...)
+        "Structs", [structtable](MemoryBuffer& self, sol::this_state ts, const MemoryBuffer::Layout& layout, size_t offset, size_t count, size_t stride) -> sol::table {
+            sol::state_view lua(ts);
+
+            count = (std::min)(count, self.getsize());
+            sol::table result = lua.create_table((int)count, 0);
+            for (size_t i = 0; i < count; i++)
+                result[i + 1] = structtable(ts, self, layout, offset + i * stride);
+            return result;
+        },
+        "Release", &MemoryBuffer::free
     );
 
-    lua_state.new_usertype<Asset>("Asset",
+    // Sample("player.money", 10, 60) keeps the last minute of money at 10 samples per second
+    lua_state.set_function("Sample", [](const std::string& name, double rate, double window) -> std::shared_ptr<FieldSeries> {
+        FieldId id = FieldRegistry::find(name);
+
+        if (id == FieldId::Count || FieldRegistry::fields[(size_t)id].type != FieldType::Int || !(rate > 0) || !(window > 0)) {
+            Logger::warning(ModContext::getname(ModContext::getcurrent()), "Sample('{}'): needs an int field, a rate and a window above 0", name);
+            return nullptr;
+        }
+        rate = (std::min)(rate, ChangeSampler::getrate());
+        size_t capacity = (size_t)(std::min)(std::ceil(rate * window), (double)FieldSeries::MAX_CAPACITY);
+        capacity = (std::max)(capacity, (size_t)1);
+        auto series = FieldSeries::create(id, ModContext::getcurrent(), (int64_t)(1000000.0 / rate), capacity);
+        if (!series) {
+            Logger::warning(ModContext::getname(ModContext::getcurrent()), "Sample('{}'): not enough memory left for {} KB of samples", name, FieldSeries::getmemory(capacity) / 1024);
+            // dropped series only give their memory back once collected
+            LuaManager::requestfullgc();
+        }
+        return series;
+    });
+    lua_state.new_usertype<FieldSeries>("Series",
         sol::no_constructor,
-        "GetAssetFilePath", [](Asset& self, unsigned int offset) -> std::string {
-            return Asset::getassetfilepath(offset);
+        "Count", &FieldSeries::size,
+        "Last", &FieldSeries::getlast,
+        "Min", &FieldSeries::getmin,
+        "Max", &FieldSeries::getmax,
+        "Mean", &FieldSeries::getmean,
+        "Rate", &FieldSeries::getrate,
+        "Values", [](FieldSeries& self, sol::this_state ts) -> sol::table {
+            sol::state_view lua(ts);
+            std::vector<int> values;
+
+            self.getwindow(values);
+            sol::table result = lua.create_table((int)values.size(), 0);
+            for (size_t i = 0; i < values.size(); i++)
+                result[i + 1] = values[i];
+            return result;
         },
-        "SetAssetFilePath", [](Asset& self, unsigned int offset, const std::string filepath) {
-            Asset::setassetfilepath(offset, filepath);
+        "Stop", [](FieldSeries& self) {
+            FieldSeries::remove(&self);
+        }
+    );
+
+    lua_state.set_function("ReadFileAsync", readfileasync);
+    lua_state.set_function("WriteFileAsync", writefileasync);
+    lua_state.set_function("AppendFileAsync", appendfileasync);
+    lua_state.set_function("ListDirectoryAsync", listdirectoryasync);
+
+    lua_state.set_function("GetMemoryUsage", []() -> size_t {
+        return LuaAllocator::getstats(ModContext::getcurrent()).used.load(std::memory_order_relaxed);
+    });
+
+    lua_state.set_function("GetMemoryStats", [](sol::this_state ts) -> sol::table {
+        sol::state_view lua(ts);
+        sol::table result = lua.create_table();
+
+        for (int i = 0; i < (int)ModContext::count(); i++) {
+            const LuaAllocator::Stats& stats = LuaAllocator::getstats(i);
+            result[ModContext::getname(i)] = lua.create_table_with(
+                "used", stats.used.load(std::memory_order_relaxed),
+                "peak", stats.peak.load(std::memory_order_relaxed),
+                "limit", stats.limit.load(std::memory_order_relaxed),
+                "allocations", stats.allocations.load(std::memory_order_relaxed),
+                "failures", stats.failures.load(std::memory_order_relaxed)
+            );
+        }
+        return result;
+    });
+
+    lua_state.set_function("GetGCStats", [this](sol::this_state ts) -> sol::table {
+        sol::state_view lua(ts);
+
+        return lua.create_table_with(
+            "lastpause", gcstats.lastpause,
+            "maxpause", gcstats.maxpause,
+            "lastfullpause", gcstats.lastfullpause,
+            "steps", gcstats.steps,
+            "fullcollections", gcstats.fullcollections,
+            "memory", lua_gc(lua_state.lua_state(), LUA_GCCOUNT, 0)
+        );
+    });
+
+    lua_state.set_function("SetTimeout", [](int64_t milliseconds, sol::protected_function callback) -> uint64_t {
+        return Timers::settimeout(milliseconds, callback);
+    });
+
+    lua_state.set_function("SetInterval", [](int64_t milliseconds, sol::protected_function callback) -> uint64_t {
+        return Timers::setinterval(milliseconds, callback);
+    });
+
+    lua_state.set_function("ClearTimer", [](uint64_t id) -> bool {
+        return Timers::cleartimer(id);
+    });
+
+    lua_state.create_named_table("Shared",
+        "Set", [](sol::this_state ts, const std::string& key, sol::stack_object value) -> bool {
+            std::string data;
+            std::string error;
+
+            if (!Serializer::encode(ts, value.stack_index(), data, error)) {
+                Logger::warning(ModContext::getname(ModContext::getcurrent()), "Shared.Set('{}'): {}", key, error);
+                return false;
+            }
+            if (!SharedStore::set(key, (const uint8_t*)data.data(), data.size())) {
+                Logger::warning(ModContext::getname(ModContext::getcurrent()), "Shared.Set('{}'): key or value too big, or the store is full", key);
+                return false;
+            }
+            return true;
+        },
+        "Get", [](sol::this_state ts, const std::string& key) -> sol::object {
+            static std::vector<uint8_t> buffer;
+            lua_State* L = ts;
+
+            if (!SharedStore::get(key, buffer))
+                return sol::lua_nil;
+            const uint8_t* data = buffer.data();
+            if (!Serializer::decode(L, data, data + buffer.size()))
+                return sol::lua_nil;
+            return sol::stack::pop<sol::object>(L);
+        },
+        "Version", [](const std::string& key) -> uint32_t {
+            return SharedStore::getversion(key);
+        },
+        "Subscribe", [](const std::string& key, sol::protected_function callback) {
+            SharedStore::subscribe(key, callback);
+        }
+    );
+
+    lua_state.create_named_table("Storage",
+        "Set", [](sol::this_state ts, const std::string& key, sol::stack_object value) -> bool {
+            int mod = ModContext::getcurrent();
+            std::string data;
+            std::string error;
+
+            if (value.get_type() == sol::type::lua_nil)
+                return Storage::remove(mod, key);
+            if (!Serializer::encode(ts, value.stack_index(), data, error)) {
+                Logger::warning(ModContext::getname(mod), "Storage.Set('{}'): {}", key, error);
+                return false;
+            }
+            if (!Storage::set(mod, key, data)) {
+                Logger::warning(ModContext::getname(mod), "Storage.Set('{}'): storage.max_kb reached", key);
+                return false;
+            }
+            return true;
+        },
+        "Get", [](sol::this_state ts, const std::string& key) -> sol::object {
+            const std::string* value = Storage::get(ModContext::getcurrent(), key);
+            lua_State* L = ts;
+
+            if (!value)
+                return sol::lua_nil;
+            const uint8_t* data = (const uint8_t*)value->data();
+            if (!Serializer::decode(L, data, data + value->size()))
+                return sol::lua_nil;
+            return sol::stack::pop<sol::object>(L);
+        },
+        "Remove", [](const std::string& key) -> bool {
+            return Storage::remove(ModContext::getcurrent(), key);
+        },
+        "Keys", [](sol::this_state ts) -> sol::table {
+            sol::state_view lua(ts);
+            std::vector<std::string> keys;
+
+            Storage::getkeys(ModContext::getcurrent(), keys);
+            sol::table result = lua.create_table((int)keys.size(), 0);
+            for (size_t i = 0; i < keys.size(); i++)
+                result[i + 1] = keys[i];
+            return result;
+        }
+    );
+
+    // same keys as the system/station properties
+    auto systemtable = [](lua_State* L, uint32_t index) -> sol::table {
+        sol::state_view lua(L);
+        Galaxy::SystemInfo info = Galaxy::getsystem(index);
+
+        return lua.create_table_with(
+            "id", info.id,
+            "risk", info.risk,
+            "faction", info.faction,
+            "mapcoordinate_x", info.x,
+            "mapcoordinate_y", info.y,
+            "mapcoordinate_z", info.z,
+            "jumpgatestationid", info.jumpgatestationid
+        );
+    };
+    auto systemlist = [systemtable](lua_State* L, const std::vector<uint32_t>& indices) -> sol::table {
+        sol::state_view lua(L);
+        sol::table result = lua.create_table((int)indices.size(), 0);
+
+        for (size_t i = 0; i < indices.size(); i++)
+            result[i + 1] = systemtable(L, indices[i]);
+        return result;
+    };
+
+    lua_state.create_named_table("Galaxy",
+        "GetSystem", [systemtable](sol::this_state ts, int id) -> sol::object {
+            uint32_t index;
+
+            if (!Galaxy::findsystem(id, index))
+                return sol::lua_nil;
+            return systemtable(ts, index);
+        },
+        "NearestSystems", [systemlist](sol::this_state ts, int x, int y, int z, sol::optional<int> count) -> sol::table {
+            std::vector<uint32_t> indices;
+
+            Galaxy::nearest(x, y, z, (std::max)(count.value_or(1), 0), indices);
+            return systemlist(ts, indices);
+        },
+        "SystemsInRadius", [systemlist](sol::this_state ts, int x, int y, int z, int64_t radius) -> sol::table {
+            std::vector<uint32_t> indices;
+
+            Galaxy::withinradius(x, y, z, radius, indices);
+            return systemlist(ts, indices);
+        },
+        "StationsByTechLevel", [](sol::this_state ts, int min, int max) -> sol::table {
+            sol::state_view lua(ts);
+            std::vector<uint32_t> indices;
+
+            Galaxy::stationsbytechlevel(min, max, indices);
+            sol::table result = lua.create_table((int)indices.size(), 0);
+            for (size_t i = 0; i < indices.size(); i++) {
+                Galaxy::StationInfo info = Galaxy::getstation(indices[i]);
+                result[i + 1] = lua.create_table_with("id", info.id, "level", info.techlevel, "name", info.name);
+            }
+            return result;
+        },
+        "SystemCount", []() -> size_t {
+            return Galaxy::systemcount();
+        },
+        "StationCount", []() -> size_t {
+            return Galaxy::stationcount();
         }
     );
 
@@ -88,12 +703,20 @@ void LuaManager::bind_api()
         EventManager::addlistener(name, callback);
     });
 
+    lua_state.new_usertype<GamePhase>("Game",
+        sol::no_constructor,
+        "phase", sol::readonly_property([](GamePhase& self) -> const char* {
+            return GamePhase::getname(GamePhase::get());
+        })
+    );
+
     lua_state["API_VERSION"] = "1.0";
     lua_state["player"] = Player();
     lua_state["system"] = System();
     lua_state["mission"] = Mission();
     lua_state["station"] = Station();
     lua_state["asset"] = Asset();
+    lua_state["game"] = GamePhase();
 }
 
 void LuaManager::execute_script(const std::string& filepath)
@@ -103,10 +726,10 @@ void LuaManager::execute_script(const std::string& filepath)
         
         if (!result.valid()) {
             sol::error err = result;
-            std::cout << "[LuaManager] Lua Script error: " << err.what() << std::endl;
+            Logger::error(ModContext::getname(ModContext::getcurrent()), "Lua Script error: {}", err.what());
         }
     }
     catch (const sol::error& e) {
-        std::cout << "[LuaManager] Lua exception: " << e.what() << std::endl;
+        Logger::error(ModContext::getname(ModContext::getcurrent()), "Lua exception: {}", e.what());
     }
 }
\ No newline at end of file
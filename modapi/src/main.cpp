@@ -8,35 +8,86 @@
 #include <sol/sol.hpp>
 #include <map>
 #include <string>
+#include <chrono>
+#include <thread>
 #include "modapi_utils.h"
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
 #include <Game/mission.h>
 #include <Game/asset.h>
+#include "fileio.h"
 
 DWORD WINAPI MainThread(LPVOID lpParam) {
     LuaManager *luamanager = new LuaManager();
-    FILE* dummyfile;
-    freopen_s(&dummyfile, "CONOUT$", "w", stdout);
-    freopen_s(&dummyfile, "CONOUT$", "w", stderr);
-    
-    std::cout << "[+] KaamoClubModAPI Loaded! | Version: dev-alpha" << std::endl;
+    FILE* dummyfile = nullptr;
+
+    Config::load("modapi.cfg");
+    // same key as the proxy, without its console stdout can't be reopened and the log only goes to the file
+    bool console = Config::getbool("console", true);
+    if (console) {
+        freopen_s(&dummyfile, "CONOUT$", "w", stdout);
+        freopen_s(&dummyfile, "CONOUT$", "w", stderr);
+    }
+    Logger::setconsole(console);
+    Logger::setlevel(Logger::parselevel(Config::getstring("log.level", "info"), LogLevel::Info));
+    if (Config::has("log.file") || !console)
+        Logger::setfile(Config::getstring("log.file", "modapi.log"), (size_t)Config::getint("log.file_max_kb", 1024) * 1024, Config::getint("log.file_count", 3));
+    Logger::start();
+
+    Logger::info("ModApi", "KaamoClubModAPI Loaded! | Version: dev-alpha");
     Player::init();
     System::init();
     Station::init();
     Mission::init();
     Asset::init();
+    FieldRegistry::build();
+    Galaxy::init();
+    GamePhase::init();
+    Storage::start();
+    Telemetry::start();
+    FileIO::start();
+    ChangeSampler::start();
     luamanager->init();
     luamanager->bind_api();
     ModApiUtils::load_mods(luamanager);
     
-    while (true)
-        EventManager::trigger_events();
+    int tickrate = Config::getint("tick.rate_hz", 60);
+    auto tickperiod = std::chrono::microseconds(tickrate > 0 ? 1000000 / tickrate : 0);
+    timeBeginPeriod(1);
+    while (true) {
+        auto tickstart = std::chrono::steady_clock::now();
+
+        ModApiUtils::run_tick(luamanager, tickstart + tickperiod);
+        if (tickrate > 0)
+            std::this_thread::sleep_until(tickstart + tickperiod);
+    }
+    timeEndPeriod(1);
 
+    ChangeSampler::stop();
+    FileIO::stop();
+    Telemetry::stop();
+    Storage::stop();
+    Logger::stop();
     if (dummyfile)
         fclose(dummyfile);
     FreeLibraryAndExitThread((HMODULE)lpParam, 0);
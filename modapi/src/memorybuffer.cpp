@@ -0,0 +1,174 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <cstring>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+MemoryBuffer::~MemoryBuffer()
+{
+    free();
+}
+
+size_t MemoryBuffer::getclass(size_t size)
+{
+    size_t index = 0;
+
+    while ((MIN_SIZE << index) < size)
+        index++;
+    return index;
+}
+
+uint8_t* MemoryBuffer::allocate(size_t size)
+{
+    size_t index = getclass(size);
+
+    if (freeblocks[index].empty())
+        return new uint8_t[MIN_SIZE << index];
+    uint8_t* block = freeblocks[index].back();
+    freeblocks[index].pop_back();
+    return block;
+}
+
+void MemoryBuffer::release(uint8_t* block, size_t size)
+{
+    size_t index = getclass(size);
+
+    if (freeblocks[index].size() < MAX_FREE)
+        freeblocks[index].push_back(block);
+    else
+        delete[] block;
+}
+
+uintptr_t MemoryBuffer::resolve(const std::vector<unsigned int>& chain)
+{
+    if (modulebase == 0)
+        modulebase = MemoryUtils::GetModuleBase("GoF2.exe");
+    if (chain.empty() || modulebase == 0)
+        return 0;
+    return MemoryUtils::GetPointerAddress(modulebase + chain[0], std::vector<unsigned int>(chain.begin() + 1, chain.end()));
+}
+
+bool MemoryBuffer::parsetype(const std::string& name, BufferType& type)
+{
+    static const std::pair<const char*, BufferType> names[] = {
+        { "u8", BufferType::U8 }, { "i8", BufferType::I8 }, { "u16", BufferType::U16 }, { "i16", BufferType::I16 },
+        { "u32", BufferType::U32 }, { "i32", BufferType::I32 }, { "f32", BufferType::F32 }, { "f64", BufferType::F64 },
+        { "ptr", BufferType::Ptr }, { "utf16", BufferType::UTF16 }, { "string", BufferType::String }
+    };
+
+    for (const auto& entry : names) {
+        if (name == entry.first) {
+            type = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MemoryBuffer::gettypesize(BufferType type)
+{
+    switch (type) {
+    case BufferType::U8:
+    case BufferType::I8:
+        return 1;
+    case BufferType::U16:
+    case BufferType::I16:
+        return 2;
+    case BufferType::U32:
+    case BufferType::I32:
+    case BufferType::F32:
+        return 4;
+    case BufferType::F64:
+        return 8;
+    case BufferType::Ptr:
+        return sizeof(uintptr_t);
+    default:
+        return 0;
+    }
+}
+
+bool MemoryBuffer::read(uintptr_t address, size_t readsize)
+{
+    SIZE_T bytesread = 0;
+
+    free();
+    if (address == 0 || readsize == 0 || readsize > MAX_SIZE)
+        return false;
+    data = allocate(readsize);
+    size = readsize;
+    if (!ReadProcessMemory(GetCurrentProcess(), (LPCVOID)address, data, size, &bytesread) || bytesread != size) {
+        free();
+        return false;
+    }
+    return true;
+}
+
+void MemoryBuffer::free()
+{
+    if (data)
+        release(data, size);
+    data = nullptr;
+    size = 0;
+}
+
+size_t MemoryBuffer::getsize() const
+{
+    return size;
+}
+
+bool MemoryBuffer::getutf16(size_t offset, size_t length, std::string& out) const
+{
+    if (!data || offset > size || length > (size - offset) / sizeof(wchar_t))
+        return false;
+    std::wstring text((const wchar_t*)(data + offset), length);
+    size_t end = text.find(L'\0');
+    if (end != std::wstring::npos)
+        text.resize(end);
+    out.clear();
+    if (text.empty())
+        return true;
+    int outsize = WideCharToMultiByte(CP_UTF8, 0, text.data(), (int)text.size(), NULL, 0, NULL, NULL);
+    out.resize(outsize);
+    WideCharToMultiByte(CP_UTF8, 0, text.data(), (int)text.size(), out.data(), outsize, NULL, NULL);
+    return true;
+}
+
+bool MemoryBuffer::getstring(size_t offset, size_t length, std::string& out) const
+{
+    if (!data || offset > size || length > size - offset)
+        return false;
+    const char* text = (const char*)(data + offset);
+    out.assign(text, strnlen(text, length));
+    return true;
+}
\ No newline at end of file
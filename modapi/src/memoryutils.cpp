@@ -12,6 +12,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -19,9 +35,17 @@
 #include <Game/asset.h>
 
 uintptr_t MemoryUtils::GetModuleBase(const char* modulename) {
+    auto it = modulebases.find(modulename);
+
+    if (it != modulebases.end())
+        return it->second;
     return (uintptr_t)GetModuleHandleA(modulename);
 }
 
+void MemoryUtils::OverrideModuleBase(const char* modulename, uintptr_t base) {
+    modulebases[modulename] = base;
+}
+
 uintptr_t MemoryUtils::GetPointerAddress(uintptr_t startaddr, const std::vector<unsigned int>& offsets) {
     uintptr_t addr = startaddr;
 
@@ -0,0 +1,607 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#endif
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <set>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MEMSCANNER_SSE2
+#endif
+#include "memscanner.h"
+
+// The scanner is used outside of the modapi (and on Linux), it only depends on the OS
+
+static constexpr size_t CHUNK_SIZE = 1024 * 1024;
+static constexpr size_t MIN_CLASS = 64;
+static constexpr int CLASS_COUNT = 15; // 64 B .. 1 MB
+
+static std::mutex ownedmutex;
+static std::set<std::pair<uintptr_t, uintptr_t>> ownedpages;
+static void* freelists[CLASS_COUNT] = {};
+static uint8_t* chunkcursor = nullptr;
+static uint8_t* chunkend = nullptr;
+
+static void* allocatepages(size_t size)
+{
+#ifdef _WIN32
+    void* pointer = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pointer == MAP_FAILED)
+        pointer = nullptr;
+#endif
+    if (!pointer)
+        throw std::bad_alloc();
+    ownedpages.insert({ (uintptr_t)pointer, (uintptr_t)pointer + size });
+    return pointer;
+}
+
+static void freepages(void* pointer, size_t size)
+{
+    ownedpages.erase({ (uintptr_t)pointer, (uintptr_t)pointer + size });
+#ifdef _WIN32
+    VirtualFree(pointer, 0, MEM_RELEASE);
+#else
+    munmap(pointer, size);
+#endif
+}
+
+static int getclass(size_t size)
+{
+    int index = 0;
+
+    for (size_t classsize = MIN_CLASS; classsize < size; classsize <<= 1)
+        index++;
+    return index;
+}
+
+// Power of two classes carved out of 1 MB chunks, freed blocks are kept for the next scans. Bigger blocks get their own pages.
+void* MemoryScanner::allocatememory(size_t size)
+{
+    std::lock_guard<std::mutex> lock(ownedmutex);
+    int index = getclass(size);
+
+    if (index >= CLASS_COUNT)
+        return allocatepages(size);
+    if (freelists[index]) {
+        void* block = freelists[index];
+        freelists[index] = *(void**)block;
+        return block;
+    }
+    size_t classsize = MIN_CLASS << index;
+    if ((size_t)(chunkend - chunkcursor) < classsize) {
+        chunkcursor = (uint8_t*)allocatepages(CHUNK_SIZE);
+        chunkend = chunkcursor + CHUNK_SIZE;
+    }
+    void* block = chunkcursor;
+    chunkcursor += classsize;
+    return block;
+}
+
+void MemoryScanner::freememory(void* pointer, size_t size)
+{
+    std::lock_guard<std::mutex> lock(ownedmutex);
+    int index = getclass(size);
+
+    if (index >= CLASS_COUNT) {
+        freepages(pointer, size);
+        return;
+    }
+    *(void**)pointer = freelists[index];
+    freelists[index] = pointer;
+}
+
+// Copies instead of dereferencing, the game can free a region while we are in it
+bool MemoryScanner::readmemory(uintptr_t address, void* buffer, size_t size)
+{
+#ifdef _WIN32
+    SIZE_T read = 0;
+    return ReadProcessMemory(GetCurrentProcess(), (LPCVOID)address, buffer, size, &read) && read == size;
+#else
+    struct iovec local = { buffer, size };
+    struct iovec remote = { (void*)address, size };
+    return process_vm_readv(getpid(), &local, 1, &remote, 1, 0) == (ssize_t)size;
+#endif
+}
+
+void MemoryScanner::getregions(std::vector<Region>& out)
+{
+    std::vector<Region> regions;
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    MEMORY_BASIC_INFORMATION mbi;
+    const DWORD readable = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+
+    GetSystemInfo(&info);
+    uintptr_t address = (uintptr_t)info.lpMinimumApplicationAddress;
+    while (address < (uintptr_t)info.lpMaximumApplicationAddress && VirtualQuery((LPCVOID)address, &mbi, sizeof(mbi)) == sizeof(mbi)) {
+        // mapped files are skipped, nothing the game changes lives there
+        if (mbi.State == MEM_COMMIT && (mbi.Protect & readable) && !(mbi.Protect & PAGE_GUARD) && mbi.Type != MEM_MAPPED)
+            regions.push_back({ (uintptr_t)mbi.BaseAddress, mbi.RegionSize });
+        address = (uintptr_t)mbi.BaseAddress + mbi.RegionSize;
+    }
+#else
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+
+    while (std::getline(maps, line)) {
+        std::istringstream stream(line);
+        std::string range, permissions, offset, device, inode, path;
+        stream >> range >> permissions >> offset >> device >> inode;
+        std::getline(stream, path);
+        if (permissions.empty() || permissions[0] != 'r' || path.find("[vvar") != std::string::npos || path.find("[vsyscall]") != std::string::npos)
+            continue;
+        size_t dash = range.find('-');
+        if (dash == std::string::npos)
+            continue;
+        uintptr_t begin = (uintptr_t)std::stoull(range.substr(0, dash), nullptr, 16);
+        uintptr_t end = (uintptr_t)std::stoull(range.substr(dash + 1), nullptr, 16);
+        regions.push_back({ begin, end - begin });
+    }
+#endif
+
+    // cut our own pages out (neighbour mappings can be merged with them on Linux)
+    std::vector<std::pair<uintptr_t, uintptr_t>> owned;
+    {
+        std::lock_guard<std::mutex> lock(ownedmutex);
+        owned.assign(ownedpages.begin(), ownedpages.end());
+    }
+    for (const Region& region : regions) {
+        uintptr_t begin = region.base;
+        uintptr_t end = region.base + region.size;
+        auto it = std::lower_bound(owned.begin(), owned.end(), std::make_pair(begin, (uintptr_t)0));
+        if (it != owned.begin() && std::prev(it)->second > begin)
+            --it;
+        for (; it != owned.end() && it->first < end && begin < end; ++it) {
+            if (it->first > begin)
+                out.push_back({ begin, it->first - begin });
+            begin = (std::max)(begin, it->second);
+        }
+        if (begin < end)
+            out.push_back({ begin, end - begin });
+    }
+}
+
+void MemoryScanner::parallelfor(size_t count, const std::function<void(size_t)>& job)
+{
+    std::atomic<size_t> nextindex{ 0 };
+    size_t threadcount = (std::min)((size_t)(std::max)(std::thread::hardware_concurrency(), 1u), count);
+    std::vector<std::thread> threads;
+
+    auto run = [&]() {
+        for (size_t i = nextindex++; i < count; i = nextindex++)
+            job(i);
+    };
+    for (size_t i = 1; i < threadcount; i++)
+        threads.emplace_back(run);
+    run();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+bool MemoryScanner::parsetype(const std::string& name, ScanType& type)
+{
+    if (name == "int")
+        type = ScanType::Int;
+    else if (name == "float")
+        type = ScanType::Float;
+    else if (name == "string")
+        type = ScanType::String;
+    else if (name == "utf16")
+        type = ScanType::WString;
+    else
+        return false;
+    return true;
+}
+
+bool MemoryScanner::parsecompare(const std::string& name, ScanCompare& compare)
+{
+    if (name == "exact")
+        compare = ScanCompare::Exact;
+    else if (name == "range")
+        compare = ScanCompare::Range;
+    else if (name == "changed")
+        compare = ScanCompare::Changed;
+    else if (name == "unchanged")
+        compare = ScanCompare::Unchanged;
+    else if (name == "increased")
+        compare = ScanCompare::Increased;
+    else if (name == "decreased")
+        compare = ScanCompare::Decreased;
+    else
+        return false;
+    return true;
+}
+
+MemoryScanner::MemoryScanner(ScanType type) : type(type)
+{
+}
+
+MemoryScanner::~MemoryScanner()
+{
+    if (worker.joinable())
+        worker.join();
+    pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+}
+
+// The game strings are UTF-16, the lua ones UTF-8
+bool MemoryScanner::setpattern(const std::string& text)
+{
+    pattern.clear();
+    if (type == ScanType::String) {
+        pattern.assign(text.begin(), text.end());
+        return !pattern.empty();
+    }
+    for (size_t i = 0; i < text.size();) {
+        uint8_t byte = (uint8_t)text[i];
+        int length = byte < 0x80 ? 1 : (byte >> 5) == 0x6 ? 2 : (byte >> 4) == 0xE ? 3 : (byte >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size())
+            return false;
+        uint32_t codepoint = length == 1 ? byte : byte & (0x7F >> length);
+        for (int j = 1; j < length; j++)
+            codepoint = (codepoint << 6) | ((uint8_t)text[i + j] & 0x3F);
+        i += length;
+        uint16_t units[2];
+        int unitcount = 1;
+        if (codepoint >= 0x10000) {
+            codepoint -= 0x10000;
+            units[0] = (uint16_t)(0xD800 | (codepoint >> 10));
+            units[1] = (uint16_t)(0xDC00 | (codepoint & 0x3FF));
+            unitcount = 2;
+        } else {
+            units[0] = (uint16_t)codepoint;
+        }
+        for (int j = 0; j < unitcount; j++) {
+            pattern.push_back((uint8_t)(units[j] & 0xFF));
+            pattern.push_back((uint8_t)(units[j] >> 8));
+        }
+    }
+    return !pattern.empty();
+}
+
+bool MemoryScanner::addresult(Block& block, size_t offset, uint32_t value)
+{
+    if (results.fetch_add(1, std::memory_order_relaxed) >= MAX_RESULTS) {
+        results.fetch_sub(1, std::memory_order_relaxed);
+        truncated.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    block.offsets.push_back((uint32_t)offset);
+    if (type == ScanType::Int || type == ScanType::Float)
+        block.values.push_back(value);
+    return true;
+}
+
+// Turns the lua numbers into the raw 32 bits compared against memory
+bool MemoryScanner::getbounds(double a, double b, uint32_t& rawa, uint32_t& rawb)
+{
+    if (type == ScanType::Int) {
+        int32_t low = (int32_t)a;
+        int32_t high = (int32_t)b;
+        memcpy(&rawa, &low, sizeof(rawa));
+        memcpy(&rawb, &high, sizeof(rawb));
+    } else {
+        float low = (float)a;
+        float high = (float)b;
+        memcpy(&rawa, &low, sizeof(rawa));
+        memcpy(&rawb, &high, sizeof(rawb));
+    }
+    return true;
+}
+
+static bool matches(ScanType type, ScanCompare compare, uint32_t value, uint32_t previous, uint32_t a, uint32_t b)
+{
+    if (type == ScanType::Int) {
+        int32_t current = (int32_t)value;
+        int32_t old = (int32_t)previous;
+        switch (compare) {
+        case ScanCompare::Exact:
+            return current == (int32_t)a;
+        case ScanCompare::Range:
+            return current >= (int32_t)a && current <= (int32_t)b;
+        case ScanCompare::Changed:
+            return current != old;
+        case ScanCompare::Unchanged:
+            return current == old;
+        case ScanCompare::Increased:
+            return current > old;
+        case ScanCompare::Decreased:
+            return current < old;
+        }
+        return false;
+    }
+    float current, old, low, high;
+    memcpy(&current, &value, sizeof(current));
+    memcpy(&old, &previous, sizeof(old));
+    memcpy(&low, &a, sizeof(low));
+    memcpy(&high, &b, sizeof(high));
+    switch (compare) {
+    case ScanCompare::Exact:
+        return current == low;
+    case ScanCompare::Range:
+        return current >= low && current <= high;
+    case ScanCompare::Changed:
+        return value != previous;
+    case ScanCompare::Unchanged:
+        return value == previous;
+    case ScanCompare::Increased:
+        return current > old;
+    case ScanCompare::Decreased:
+        return current < old;
+    }
+    return false;
+}
+
+void MemoryScanner::firstblock(Block& block, ScanCompare compare, uint32_t a, uint32_t b)
+{
+    thread_local Vector<uint8_t> buffer;
+    // string matches may start in this block and end in the next one
+    size_t size = (std::min)((size_t)(block.limit - block.base), block.size + (pattern.empty() ? 0 : pattern.size() - 1));
+
+    buffer.resize(size);
+    if (!readmemory(block.base, buffer.data(), size))
+        return;
+    const uint8_t* data = buffer.data();
+
+    if (type == ScanType::String || type == ScanType::WString) {
+        size_t step = type == ScanType::WString ? 2 : 1;
+        size_t last = size >= pattern.size() ? (std::min)(block.size, size - pattern.size() + 1) : 0;
+        size_t i = 0;
+#ifdef MEMSCANNER_SSE2
+        __m128i first = _mm_set1_epi8((char)pattern[0]);
+        for (; i + 16 <= last; i += 16) {
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), first));
+            if (step == 2)
+                mask &= 0x5555;
+            while (mask) {
+                size_t offset = i + std::countr_zero(mask);
+                mask &= mask - 1;
+                if (memcmp(data + offset, pattern.data(), pattern.size()) == 0 && !addresult(block, offset, 0))
+                    return;
+            }
+        }
+#endif
+        for (; i < last; i += step) {
+            if (data[i] == pattern[0] && memcmp(data + i, pattern.data(), pattern.size()) == 0 && !addresult(block, i, 0))
+                return;
+        }
+        return;
+    }
+
+    size_t i = 0;
+#ifdef MEMSCANNER_SSE2
+    if (type == ScanType::Int) {
+        __m128i low = _mm_set1_epi32((int)a);
+        __m128i high = _mm_set1_epi32((int)b);
+        for (; i + 16 <= size; i += 16) {
+            __m128i values = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i hits = compare == ScanCompare::Exact ? _mm_cmpeq_epi32(values, low)
+                : _mm_andnot_si128(_mm_or_si128(_mm_cmplt_epi32(values, low), _mm_cmpgt_epi32(values, high)), _mm_set1_epi32(-1));
+            unsigned int mask = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(hits));
+            while (mask) {
+                size_t offset = i + std::countr_zero(mask) * 4;
+                mask &= mask - 1;
+                uint32_t value;
+                memcpy(&value, data + offset, sizeof(value));
+                if (!addresult(block, offset, value))
+                    return;
+            }
+        }
+    } else {
+        float lowvalue, highvalue;
+        memcpy(&lowvalue, &a, sizeof(lowvalue));
+        memcpy(&highvalue, &b, sizeof(highvalue));
+        __m128 low = _mm_set1_ps(lowvalue);
+        __m128 high = _mm_set1_ps(compare == ScanCompare::Exact ? lowvalue : highvalue);
+        for (; i + 16 <= size; i += 16) {
+            __m128 values = _mm_loadu_ps((const float*)(data + i));
+            unsigned int mask = (unsigned int)_mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(values, low), _mm_cmple_ps(values, high)));
+            while (mask) {
+                size_t offset = i + std::countr_zero(mask) * 4;
+                mask &= mask - 1;
+                uint32_t value;
+                memcpy(&value, data + offset, sizeof(value));
+                if (!addresult(block, offset, value))
+                    return;
+            }
+        }
+    }
+#endif
+    for (; i + 4 <= size; i += 4) {
+        uint32_t value;
+        memcpy(&value, data + i, sizeof(value));
+        if (matches(type, compare, value, value, a, b) && !addresult(block, i, value))
+            return;
+    }
+}
+
+// Results are sparse, only the span between the first and last one is read
+void MemoryScanner::nextblock(Block& block, ScanCompare compare, uint32_t a, uint32_t b)
+{
+    thread_local Vector<uint8_t> buffer;
+    Vector<uint32_t> offsets;
+    Vector<uint32_t> values;
+    size_t width = type == ScanType::Int || type == ScanType::Float ? 4 : pattern.size();
+    size_t begin = block.offsets.front();
+    size_t end = (std::min)((size_t)block.offsets.back() + width, (size_t)(block.limit - block.base));
+
+    if (end >= begin + width) {
+        buffer.resize(end - begin);
+        if (!readmemory(block.base + begin, buffer.data(), end - begin))
+            end = begin;
+    }
+    // the region is gone (or shrank), so are the results
+    if (end < begin + width) {
+        block.offsets.clear();
+        block.values.clear();
+        return;
+    }
+    offsets.swap(block.offsets);
+    values.swap(block.values);
+    for (size_t i = 0; i < offsets.size(); i++) {
+        size_t offset = offsets[i];
+        if (offset + width > end)
+            break;
+        const uint8_t* data = buffer.data() + (offset - begin);
+        bool keep;
+        uint32_t value = 0;
+
+        if (width == 4 && (type == ScanType::Int || type == ScanType::Float)) {
+            memcpy(&value, data, sizeof(value));
+            keep = matches(type, compare, value, values[i], a, b);
+        } else {
+            bool equal = memcmp(data, pattern.data(), pattern.size()) == 0;
+            keep = compare == ScanCompare::Changed ? !equal : equal;
+        }
+        if (keep) {
+            block.offsets.push_back((uint32_t)offset);
+            if (type == ScanType::Int || type == ScanType::Float)
+                block.values.push_back(value);
+        }
+    }
+}
+
+size_t MemoryScanner::compactblocks()
+{
+    size_t total = 0;
+
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [](const Block& block) { return block.offsets.empty(); }), blocks.end());
+    for (const Block& block : blocks)
+        total += block.offsets.size();
+    results = total;
+    return total;
+}
+
+bool MemoryScanner::first(ScanCompare compare, double a, double b, const std::string& text)
+{
+    std::vector<Region> regions;
+    uint32_t rawa = 0, rawb = 0;
+    bool numeric = type == ScanType::Int || type == ScanType::Float;
+
+    if (numeric ? (compare != ScanCompare::Exact && compare != ScanCompare::Range) : (compare != ScanCompare::Exact || !setpattern(text)))
+        return false;
+    if (numeric) {
+        getbounds(a, compare == ScanCompare::Range ? b : a, rawa, rawb);
+        pattern.clear();
+    }
+    blocks.clear();
+    results = 0;
+    truncated = false;
+    getregions(regions);
+    for (const Region& region : regions) {
+        for (size_t offset = 0; offset < region.size; offset += BLOCK_SIZE)
+            blocks.push_back({ region.base + offset, (std::min)(BLOCK_SIZE, region.size - offset), region.base + region.size, {}, {} });
+    }
+    parallelfor(blocks.size(), [&](size_t i) {
+        firstblock(blocks[i], compare, rawa, rawb);
+    });
+    compactblocks();
+    scanned = true;
+    return true;
+}
+
+bool MemoryScanner::next(ScanCompare compare, double a, double b, const std::string& text)
+{
+    uint32_t rawa = 0, rawb = 0;
+
+    if (!scanned)
+        return first(compare, a, b, text);
+    if (type == ScanType::Int || type == ScanType::Float) {
+        getbounds(a, compare == ScanCompare::Range ? b : a, rawa, rawb);
+    } else {
+        // a string keeps its length, "exact" can only look for another text of the same size
+        if (compare == ScanCompare::Exact) {
+            size_t size = pattern.size();
+            if (!setpattern(text) || pattern.size() != size)
+                return false;
+        } else if (compare != ScanCompare::Changed && compare != ScanCompare::Unchanged) {
+            return false;
+        }
+    }
+    parallelfor(blocks.size(), [&](size_t i) {
+        nextblock(blocks[i], compare, rawa, rawb);
+    });
+    compactblocks();
+    return true;
+}
+
+bool MemoryScanner::start(std::function<bool(MemoryScanner&)> scan, std::function<void(size_t)> callback)
+{
+    if (isbusy())
+        return false;
+    if (worker.joinable())
+        worker.join();
+    oncomplete = std::move(callback);
+    finished = false;
+    pending.push_back(this);
+    worker = std::thread([this, scan = std::move(scan)]() {
+        scan(*this);
+        finished = true;
+    });
+    return true;
+}
+
+bool MemoryScanner::isbusy()
+{
+    return std::find(pending.begin(), pending.end(), this) != pending.end();
+}
+
+// Called from the thread that started the scans, callbacks can start new ones
+void MemoryScanner::dispatch()
+{
+    std::vector<MemoryScanner*> done;
+
+    for (MemoryScanner* scanner : pending) {
+        if (scanner->finished)
+            done.push_back(scanner);
+    }
+    for (MemoryScanner* scanner : done) {
+        scanner->worker.join();
+        pending.erase(std::remove(pending.begin(), pending.end(), scanner), pending.end());
+        std::function<void(size_t)> callback = std::move(scanner->oncomplete);
+        if (callback)
+            callback(scanner->count());
+    }
+}
+
+size_t MemoryScanner::count()
+{
+    return results;
+}
+
+bool MemoryScanner::istruncated()
+{
+    return truncated;
+}
+
+void MemoryScanner::getresults(std::vector<uintptr_t>& out, size_t max)
+{
+    for (const Block& block : blocks) {
+        for (uint32_t offset : block.offsets) {
+            if (out.size() >= max)
+                return;
+            out.push_back(block.base + offset);
+        }
+    }
+}
+
+void MemoryScanner::reset()
+{
+    blocks.clear();
+    pattern.clear();
+    results = 0;
+    truncated = false;
+    scanned = false;
+}
\ No newline at end of file
@@ -12,6 +12,22 @@
 #include "luamanager.h"
 #include "memoryutils.h"
 #include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
 #include <Game/player.h>
 #include <Game/system.h>
 #include <Game/station.h>
@@ -68,17 +84,15 @@ void ModApiUtils::suspendgame(bool suspend)
             while (ResumeThread(hMainThread) > 1);
         CloseHandle(hMainThread);
     } else {
-        std::cout << "[-] Couldn't open main game thread??? black magic????" << std::endl;
+        Logger::error("ModApi", "Couldn't open main game thread??? black magic????");
     }
 }
 
-void ModApiUtils::load_mods(LuaManager *luamanager)
+void ModApiUtils::load_mods(LuaManager *luamanager, const std::string& mods_folder)
 {
-    std::string mods_folder = "mods";
-    
     // TODO: make a folder lol
     if (!std::filesystem::exists(mods_folder) || !std::filesystem::is_directory(mods_folder)) {
-        std::cout << "[-] Mods folder not found: " << mods_folder << std::endl;
+        Logger::error("ModApi", "Mods folder not found: {}", mods_folder);
         return;
     }
 
@@ -88,10 +102,25 @@ void ModApiUtils::load_mods(LuaManager *luamanager)
             std::string init_lua = mod_path + "/init.lua";
             
             if (std::filesystem::exists(init_lua)) {
-                std::cout << "[*] Loading mod: " << entry.path().filename().string() << std::endl;
-                
+                std::string mod_name = entry.path().filename().string();
+                Logger::info("ModApi", "Loading mod: {}", mod_name);
+
+                int mod = ModContext::registermod(mod_name, mod_path);
+                int limit = Config::getint("lua.memory_limit_kb." + mod_name, Config::getint("lua.memory_limit_kb", 0));
+                LuaAllocator::setlimit(mod, (size_t)limit * 1024);
+
+                ModContext::Scope scope(mod);
+                auto start = std::chrono::steady_clock::now();
                 luamanager->execute_script(init_lua);
+                EventManager::record(mod, "script", init_lua, std::chrono::steady_clock::now() - start, false);
+                Logger::debug("ModApi", "{} uses {} KB of lua memory after init", mod_name, LuaAllocator::getstats(mod).used.load(std::memory_order_relaxed) / 1024);
             }
         }
     }    
+}
+
+void ModApiUtils::run_tick(LuaManager *luamanager, std::chrono::steady_clock::time_point deadline)
+{
+    EventManager::trigger_events();
+    luamanager->collectgarbage(deadline);
 }
\ No newline at end of file
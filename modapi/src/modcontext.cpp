@@ -0,0 +1,80 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+ModContext::Scope::Scope(int id) : previous(ModContext::getcurrent())
+{
+    ModContext::setcurrent(id);
+}
+
+ModContext::Scope::~Scope()
+{
+    ModContext::setcurrent(previous);
+}
+
+int ModContext::registermod(const std::string& name, const std::string& path)
+{
+    mods.push_back({ name, path });
+    return (int)mods.size() - 1;
+}
+
+int ModContext::getcurrent()
+{
+    return current;
+}
+
+void ModContext::setcurrent(int id)
+{
+    current = id;
+}
+
+const std::string& ModContext::getname(int id)
+{
+    if (id < 0 || id >= (int)mods.size())
+        return mods[0].name;
+    return mods[id].name;
+}
+
+const std::string& ModContext::getpath(int id)
+{
+    if (id < 0 || id >= (int)mods.size())
+        return mods[0].path;
+    return mods[id].path;
+}
+
+size_t ModContext::count()
+{
+    return mods.size();
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <cstring>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+enum SerializedTag : uint8_t {
+    TAG_NIL,
+    TAG_FALSE,
+    TAG_TRUE,
+    TAG_INTEGER,
+    TAG_NUMBER,
+    TAG_STRING,
+    TAG_TABLE
+};
+
+void Serializer::writevarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+bool Serializer::readvarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool Serializer::encode(lua_State* L, int index, std::string& out, std::string& error, int depth)
+{
+    index = lua_absindex(L, index);
+    switch (lua_type(L, index)) {
+    case LUA_TNIL:
+        out.push_back(TAG_NIL);
+        return true;
+    case LUA_TBOOLEAN:
+        out.push_back(lua_toboolean(L, index) ? TAG_TRUE : TAG_FALSE);
+        return true;
+    case LUA_TNUMBER:
+        if (lua_isinteger(L, index)) {
+            int64_t value = (int64_t)lua_tointeger(L, index);
+            out.push_back(TAG_INTEGER);
+            writevarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+        } else {
+            double value = (double)lua_tonumber(L, index);
+            char bytes[sizeof(value)];
+            memcpy(bytes, &value, sizeof(value));
+            out.push_back(TAG_NUMBER);
+            out.append(bytes, sizeof(bytes));
+        }
+        return true;
+    case LUA_TSTRING: {
+        size_t length;
+        const char* str = lua_tolstring(L, index, &length);
+        out.push_back(TAG_STRING);
+        writevarint(out, length);
+        out.append(str, length);
+        return true;
+    }
+    case LUA_TTABLE: {
+        if (depth >= MAX_DEPTH) {
+            error = "table nested too deep";
+            return false;
+        }
+        // the count isn't known before walking the table so the pairs are encoded aside first
+        uint64_t count = 0;
+        std::string body;
+
+        lua_pushnil(L);
+        while (lua_next(L, index)) {
+            if (!encode(L, -2, body, error, depth + 1) || !encode(L, -1, body, error, depth + 1)) {
+                lua_pop(L, 2);
+                return false;
+            }
+            lua_pop(L, 1);
+            count++;
+        }
+        out.push_back(TAG_TABLE);
+        writevarint(out, count);
+        out.append(body);
+        return true;
+    }
+    default:
+        error = std::string("can't store a ") + lua_typename(L, lua_type(L, index));
+        return false;
+    }
+}
+
+bool Serializer::decode(lua_State* L, const uint8_t*& data, const uint8_t* end, int depth)
+{
+    uint64_t value;
+
+    if (data >= end || depth > MAX_DEPTH || !lua_checkstack(L, 3))
+        return false;
+    switch (*data++) {
+    case TAG_NIL:
+        lua_pushnil(L);
+        return true;
+    case TAG_FALSE:
+        lua_pushboolean(L, 0);
+        return true;
+    case TAG_TRUE:
+        lua_pushboolean(L, 1);
+        return true;
+    case TAG_INTEGER:
+        if (!readvarint(data, end, value))
+            return false;
+        lua_pushinteger(L, (lua_Integer)((int64_t)(value >> 1) ^ -(int64_t)(value & 1)));
+        return true;
+    case TAG_NUMBER: {
+        double number;
+        if (end - data < (ptrdiff_t)sizeof(number))
+            return false;
+        memcpy(&number, data, sizeof(number));
+        data += sizeof(number);
+        lua_pushnumber(L, (lua_Number)number);
+        return true;
+    }
+    case TAG_STRING:
+        if (!readvarint(data, end, value) || (uint64_t)(end - data) < value)
+            return false;
+        lua_pushlstring(L, (const char*)data, (size_t)value);
+        data += value;
+        return true;
+    case TAG_TABLE:
+        if (!readvarint(data, end, value) || value > (uint64_t)(end - data))
+            return false;
+        lua_createtable(L, 0, (int)value);
+        for (uint64_t i = 0; i < value; i++) {
+            if (!decode(L, data, end, depth + 1)) {
+                lua_pop(L, 1);
+                return false;
+            }
+            if (!decode(L, data, end, depth + 1)) {
+                lua_pop(L, 2);
+                return false;
+            }
+            // corrupt data could hand us keys lua refuses, skip them instead of raising
+            if (lua_isnil(L, -2) || (lua_type(L, -2) == LUA_TNUMBER && lua_tonumber(L, -2) != lua_tonumber(L, -2))) {
+                lua_pop(L, 2);
+                continue;
+            }
+            lua_rawset(L, -3);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <cstring>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+#include "sharedstore.h"
+
+SharedStore::Slot SharedStore::slots[SharedStore::CAPACITY];
+
+// FNV-1a
+uint32_t SharedStore::gethash(std::string_view key)
+{
+    uint32_t hash = 2166136261u;
+
+    for (char c : key)
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    return hash;
+}
+
+// Keys are published once (used goes true after the key is written) and never removed, so probing needs no lock
+SharedStore::Slot* SharedStore::find(std::string_view key)
+{
+    uint32_t hash = gethash(key);
+
+    for (size_t i = 0; i < CAPACITY; i++) {
+        Slot& slot = slots[(hash + i) % CAPACITY];
+
+        if (!slot.used.load(std::memory_order_acquire))
+            return nullptr;
+        if (slot.hash == hash && slot.keylength == key.size() && memcmp(slot.key, key.data(), key.size()) == 0)
+            return &slot;
+    }
+    return nullptr;
+}
+
+bool SharedStore::set(std::string_view key, const uint8_t* data, size_t size)
+{
+    if (key.empty() || key.size() >= KEY_SIZE || size > VALUE_SIZE)
+        return false;
+
+    std::lock_guard<std::mutex> guard(writelock);
+    Slot* slot = find(key);
+    if (!slot) {
+        uint32_t hash = gethash(key);
+        for (size_t i = 0; i < CAPACITY && !slot; i++) {
+            Slot& candidate = slots[(hash + i) % CAPACITY];
+            if (!candidate.used.load(std::memory_order_relaxed))
+                slot = &candidate;
+        }
+        if (!slot)
+            return false;
+        slot->hash = hash;
+        slot->keylength = (uint8_t)key.size();
+        memcpy(slot->key, key.data(), key.size());
+        slot->size = 0;
+        slot->used.store(true, std::memory_order_release);
+    }
+
+    slot->lock.writebegin();
+    slot->size = (uint32_t)size;
+    memcpy(slot->data, data, size);
+    slot->lock.writeend();
+    slot->version.fetch_add(1, std::memory_order_release);
+    if (!slot->pending.exchange(true, std::memory_order_relaxed))
+        changed.push_back((uint32_t)(slot - slots));
+    return true;
+}
+
+bool SharedStore::get(std::string_view key, std::vector<uint8_t>& out, uint32_t* version)
+{
+    Slot* slot = find(key);
+    uint32_t start;
+
+    if (!slot)
+        return false;
+    do {
+        start = slot->lock.readbegin();
+        uint32_t size = slot->size;
+        out.resize(VALUE_SIZE);
+        if (size > VALUE_SIZE)
+            continue;
+        memcpy(out.data(), slot->data, size);
+        out.resize(size);
+    } while (slot->lock.readretry(start));
+    if (version)
+        *version = slot->version.load(std::memory_order_acquire);
+    return true;
+}
+
+uint32_t SharedStore::getversion(std::string_view key)
+{
+    Slot* slot = find(key);
+
+    return slot ? slot->version.load(std::memory_order_acquire) : 0;
+}
+
+void SharedStore::takechanged(std::vector<std::string>& keys)
+{
+    std::lock_guard<std::mutex> guard(writelock);
+
+    for (uint32_t index : changed) {
+        Slot& slot = slots[index];
+        slot.pending.store(false, std::memory_order_relaxed);
+        keys.emplace_back(slot.key, slot.keylength);
+    }
+    changed.clear();
+}
+
+void SharedStore::subscribe(const std::string& key, sol::protected_function callback)
+{
+    if (dispatching)
+        deferred.push_back({ key, { ModContext::getcurrent(), callback } });
+    else
+        subscribers[key].push_back({ ModContext::getcurrent(), callback });
+}
+
+void SharedStore::dispatch()
+{
+    static std::vector<std::string> keys;
+    static std::vector<uint8_t> buffer;
+
+    keys.clear();
+    takechanged(keys);
+    dispatching = true;
+    for (const std::string& key : keys) {
+        auto it = subscribers.find(key);
+        if (it == subscribers.end() || !get(key, buffer))
+            continue;
+
+        for (auto& listener : it->second) {
+            lua_State* L = listener.callback.lua_state();
+            const uint8_t* data = buffer.data();
+            if (!Serializer::decode(L, data, data + buffer.size()))
+                break;
+            sol::object value = sol::stack::pop<sol::object>(L);
+            EventManager::call(listener, "subscription", key, value, key);
+        }
+    }
+    dispatching = false;
+    for (auto& [key, listener] : deferred)
+        subscribers[key].push_back(std::move(listener));
+    deferred.clear();
+}
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <cstring>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+// FNV-1a
+uint32_t Storage::gethash(const char* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ (uint8_t)data[i]) * 16777619u;
+    return hash;
+}
+
+// value == nullptr writes a removal
+void Storage::writerecord(std::string& out, const std::string& key, const std::string* value)
+{
+    std::string body;
+    char header[HEADER_SIZE];
+
+    Serializer::writevarint(body, key.size());
+    body.append(key);
+    body.push_back(value ? 1 : 0);
+    if (value)
+        body.append(*value);
+    uint32_t size = (uint32_t)body.size();
+    uint32_t hash = gethash(body.data(), body.size());
+    memcpy(header, &size, sizeof(size));
+    memcpy(header + sizeof(size), &hash, sizeof(hash));
+    out.append(header, sizeof(header));
+    out.append(body);
+}
+
+// What writerecord appends for a set
+size_t Storage::getrecordsize(const std::string& key, const std::string& value)
+{
+    size_t varintsize = 1;
+
+    for (size_t size = key.size(); size >= 0x80; size >>= 7)
+        varintsize++;
+    return HEADER_SIZE + varintsize + key.size() + 1 + value.size();
+}
+
+Storage::Store& Storage::getstore(int mod)
+{
+    if ((size_t)mod >= stores.size())
+        stores.resize(mod + 1);
+    Store& store = stores[mod];
+    if (!store.loaded) {
+        std::string directory = ModContext::getpath(mod);
+        store.path = (directory.empty() ? std::string(".") : directory) + "/storage.dat";
+        load(store);
+        store.loaded = true;
+    }
+    return store;
+}
+
+void Storage::load(Store& store)
+{
+    HANDLE file = CreateFileA(store.path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER filesize = {};
+
+    store.values.clear();
+    store.livesize = 0;
+    store.journalsize = 0;
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+    // empty files can't be mapped, a few bytes without the magic are damaged like a bad magic
+    if (!GetFileSizeEx(file, &filesize) || filesize.QuadPart < (LONGLONG)sizeof(MAGIC)) {
+        CloseHandle(file);
+        if (filesize.QuadPart > 0) {
+            Logger::warning(ModContext::getname(ModContext::getcurrent()), "{} is damaged after 0 bytes, rewriting it", store.path);
+            compact(store);
+        }
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const uint8_t* view = mapping ? (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        Logger::error(ModContext::getname(ModContext::getcurrent()), "Couldn't map {}", store.path);
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+
+    const uint8_t* data = view;
+    const uint8_t* end = view + filesize.QuadPart;
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    if (magic == MAGIC) {
+        data += sizeof(magic);
+        // a record cut by a crash ends the journal, everything before it is kept
+        while ((size_t)(end - data) >= HEADER_SIZE) {
+            uint32_t size, hash;
+            memcpy(&size, data, sizeof(size));
+            memcpy(&hash, data + sizeof(size), sizeof(hash));
+            const uint8_t* body = data + HEADER_SIZE;
+            if ((size_t)(end - body) < size || gethash((const char*)body, size) != hash)
+                break;
+
+            const uint8_t* cursor = body;
+            const uint8_t* bodyend = body + size;
+            uint64_t keysize;
+            if (!Serializer::readvarint(cursor, bodyend, keysize) || (uint64_t)(bodyend - cursor) < keysize + 1)
+                break;
+            std::string key((const char*)cursor, (size_t)keysize);
+            cursor += keysize;
+            bool set = *cursor++ != 0;
+            auto it = store.values.find(key);
+            if (it != store.values.end()) {
+                store.livesize -= it->first.size() + it->second->size();
+                store.values.erase(it);
+            }
+            if (set) {
+                auto value = std::make_shared<const std::string>((const char*)cursor, bodyend - cursor);
+                store.livesize += key.size() + value->size();
+                store.values.emplace(std::move(key), std::move(value));
+            }
+            data = bodyend;
+        }
+    }
+    store.journalsize = data - view;
+    bool damaged = data != end;
+
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    Logger::debug(ModContext::getname(ModContext::getcurrent()), "{} keys loaded from {}", store.values.size(), store.path);
+    // appending after garbage would lose every later write on the next load, start over from what was read
+    if (damaged) {
+        Logger::warning(ModContext::getname(ModContext::getcurrent()), "{} is damaged after {} bytes, rewriting it", store.path, store.journalsize);
+        compact(store);
+    }
+}
+
+void Storage::queue(Job job)
+{
+    if (!persistent)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wakeup.notify_one();
+}
+
+// Runs on the tick: only the keys and the value handles are copied, the writer thread builds the records
+void Storage::compact(Store& store)
+{
+    Job job = { store.path, std::string(), true, {} };
+    size_t size = sizeof(MAGIC);
+
+    job.values.reserve(store.values.size());
+    for (const auto& [key, value] : store.values) {
+        job.values.emplace_back(key, value);
+        size += getrecordsize(key, *value);
+    }
+    store.journalsize = size;
+    queue(std::move(job));
+}
+
+void Storage::writerloop()
+{
+    std::deque<Job> batch;
+    std::string compacted;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (running || !jobs.empty()) {
+        wakeup.wait(lock, [] { return !running || !jobs.empty(); });
+        batch.swap(jobs);
+        lock.unlock();
+        for (const Job& job : batch) {
+            const std::string* data = &job.data;
+            if (job.replace) {
+                compacted.assign((const char*)&MAGIC, sizeof(MAGIC));
+                for (const auto& [key, value] : job.values)
+                    writerecord(compacted, key, value.get());
+                data = &compacted;
+            }
+            std::string path = job.replace ? job.path + ".tmp" : job.path;
+            FILE* file = fopen(path.c_str(), job.replace ? "wb" : "ab");
+            bool written = file && fwrite(data->data(), 1, data->size(), file) == data->size();
+
+            if (file)
+                written = fclose(file) == 0 && written;
+            if (written && job.replace)
+                written = MoveFileExA(path.c_str(), job.path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+            if (!written)
+                Logger::error("Storage", "Couldn't write {} bytes to {}", data->size(), path);
+        }
+        batch.clear();
+        lock.lock();
+    }
+}
+
+void Storage::start()
+{
+    maxsize = (size_t)(std::max)(Config::getint("storage.max_kb", 4096), 0) * 1024;
+    if (!persistent)
+        return;
+    running = true;
+    writer = std::thread(writerloop);
+}
+
+void Storage::setpersistent(bool enabled)
+{
+    persistent = enabled;
+}
+
+void Storage::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wakeup.notify_one();
+    if (writer.joinable())
+        writer.join();
+}
+
+bool Storage::set(int mod, const std::string& key, const std::string& value)
+{
+    Store& store = getstore(mod);
+    auto it = store.values.find(key);
+    size_t oldsize = it != store.values.end() ? key.size() + it->second->size() : 0;
+
+    if (maxsize > 0 && store.livesize - oldsize + key.size() + value.size() > maxsize)
+        return false;
+    std::string record;
+    // a new file starts with the magic
+    if (store.journalsize == 0)
+        record.append((const char*)&MAGIC, sizeof(MAGIC));
+    writerecord(record, key, &value);
+    store.livesize += key.size() + value.size() - oldsize;
+    store.values[key] = std::make_shared<const std::string>(value);
+    store.journalsize += record.size();
+    if (store.journalsize > COMPACT_MIN_SIZE && store.journalsize > store.livesize * 2)
+        compact(store);
+    else
+        queue({ store.path, std::move(record), false, {} });
+    return true;
+}
+
+bool Storage::remove(int mod, const std::string& key)
+{
+    Store& store = getstore(mod);
+    auto it = store.values.find(key);
+
+    if (it == store.values.end())
+        return false;
+    store.livesize -= it->first.size() + it->second->size();
+    store.values.erase(it);
+    std::string record;
+    writerecord(record, key, nullptr);
+    store.journalsize += record.size();
+    if (store.journalsize > COMPACT_MIN_SIZE && store.journalsize > store.livesize * 2)
+        compact(store);
+    else
+        queue({ store.path, std::move(record), false, {} });
+    return true;
+}
+
+const std::string* Storage::get(int mod, const std::string& key)
+{
+    Store& store = getstore(mod);
+    auto it = store.values.find(key);
+
+    return it != store.values.end() ? it->second.get() : nullptr;
+}
+
+void Storage::getkeys(int mod, std::vector<std::string>& out)
+{
+    for (const auto& entry : getstore(mod).values)
+        out.push_back(entry.first);
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+static_assert((size_t)FieldId::Count <= TELEMETRY_MAX_FIELDS, "telemetrylayout.h has room for TELEMETRY_MAX_FIELDS fields");
+
+static void copytext(char* out, size_t size, const char* text)
+{
+    size_t length = (std::min)(strlen(text), size - 1);
+
+    memcpy(out, text, length);
+    out[length] = '\0';
+}
+
+void Telemetry::start()
+{
+    uint32_t ints = 0;
+    uint32_t strings = 0;
+
+    if (!Config::getbool("telemetry.enabled", false))
+        return;
+    if (!memory.open(TELEMETRY_NAME, sizeof(TelemetryBuffer), true)) {
+        Logger::warning("Telemetry", "Can't create the shared memory (error {})", GetLastError());
+        return;
+    }
+    buffer = (TelemetryBuffer*)memory.get();
+    // The mapping outlives the game while a reader keeps it open. Only a second game still running owns it,
+    // both writing the same slots would only give garbage to the readers. A writer that is gone is taken over.
+    if (memory.existed()) {
+        uint32_t writer = buffer->writer;
+        if (buffer->magic.load(std::memory_order_acquire) == TELEMETRY_MAGIC && writer != telemetryprocess() && telemetryprocessalive(writer)) {
+            Logger::warning("Telemetry", "The shared memory is used by process {}, telemetry is disabled", writer);
+            buffer = nullptr;
+            memory.close();
+            return;
+        }
+        Logger::info("Telemetry", "Taking over the shared memory left by a previous run");
+    }
+    buffer->init(telemetryprocess());
+    for (size_t i = 0; i < (size_t)FieldId::Count; i++) {
+        const FieldInfo& info = FieldRegistry::fields[i];
+        TelemetryField& field = buffer->fields[i];
+        copytext(field.object, sizeof(field.object), info.objectname);
+        copytext(field.name, sizeof(field.name), info.luaname);
+        if (info.type == FieldType::WString) {
+            if (strings == TELEMETRY_MAX_STRINGS) {
+                Logger::warning("Telemetry", "More than {} string fields, telemetry is disabled", TELEMETRY_MAX_STRINGS);
+                memory.close();
+                buffer = nullptr;
+                return;
+            }
+            field.type = TELEMETRY_STRING;
+            field.index = strings++;
+        } else {
+            field.type = TELEMETRY_INT;
+            field.index = ints++;
+        }
+    }
+    buffer->fieldcount = (uint32_t)FieldId::Count;
+    buffer->magic.store(TELEMETRY_MAGIC, std::memory_order_release);
+    Logger::info("Telemetry", "Publishing {} fields to {}", buffer->fieldcount, TELEMETRY_NAME);
+}
+
+void Telemetry::stop()
+{
+    if (!buffer)
+        return;
+    buffer->magic.store(0, std::memory_order_release);
+    buffer = nullptr;
+    memory.close();
+}
+
+void Telemetry::publish()
+{
+    if (!buffer)
+        return;
+    TelemetrySnapshot& snapshot = buffer->beginpublish();
+    snapshot.tick = (uint32_t)EventManager::gettick();
+    snapshot.phase = (uint32_t)GamePhase::get();
+    snapshot.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    snapshot.validmask = 0;
+    for (size_t i = 0; i < (size_t)FieldId::Count; i++) {
+        const TelemetryField& field = buffer->fields[i];
+        bool valid;
+        if (field.type == TELEMETRY_STRING) {
+            std::string text = FieldRegistry::read_wstring((FieldId)i);
+            copytext(snapshot.strings[field.index], TELEMETRY_STRING_SIZE, text.c_str());
+            valid = !text.empty();
+        } else {
+            snapshot.ints[field.index] = FieldRegistry::cached((FieldId)i);
+            valid = FieldRegistry::isvalid((FieldId)i);
+        }
+        if (valid)
+            snapshot.validmask |= 1ull << i;
+    }
+    buffer->endpublish();
+}
+
+void Telemetry::takecommands(std::vector<std::string>& out)
+{
+    char text[TELEMETRY_COMMAND_SIZE];
+    size_t size;
+
+    if (!buffer)
+        return;
+    while (buffer->popcommand(text, size))
+        out.emplace_back(text, size);
+}
\ No newline at end of file
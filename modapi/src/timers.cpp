@@ -0,0 +1,105 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+#include "timers.h"
+
+uint64_t Timers::getnow()
+{
+    if (tickperiod.count() > 0)
+        return EventManager::gettick() * (uint64_t)tickperiod.count() / 1000;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+uint64_t Timers::settimeout(int64_t milliseconds, sol::protected_function callback)
+{
+    // the wheel only moves when update() runs, catch it up first so the delay counts from now
+    wheel.advance(getnow(), expired);
+    return wheel.schedule(milliseconds > 0 ? (uint64_t)milliseconds : 0, 0, { ModContext::getcurrent(), callback });
+}
+
+uint64_t Timers::setinterval(int64_t milliseconds, sol::protected_function callback)
+{
+    uint64_t interval = milliseconds > 0 ? (uint64_t)milliseconds : 1;
+
+    wheel.advance(getnow(), expired);
+    return wheel.schedule(interval, interval, { ModContext::getcurrent(), callback });
+}
+
+void Timers::settickclock(std::chrono::microseconds period)
+{
+    tickperiod = period;
+}
+
+bool Timers::cleartimer(uint64_t id)
+{
+    return wheel.cancel(id);
+}
+
+size_t Timers::count()
+{
+    return wheel.size();
+}
+
+size_t Timers::countpending()
+{
+    return wheel.countoneshot();
+}
+
+void Timers::update()
+{
+    wheel.advance(getnow(), expired);
+    // callbacks can schedule or clear timers (and so advance the wheel), only walk what was due before they ran
+    std::vector<uint64_t> due;
+    due.swap(expired);
+    for (uint64_t handle : due) {
+        EventManager::Listener* timer = wheel.get(handle);
+
+        if (timer) {
+            EventManager::Listener listener = *timer;
+            char name[24];
+            snprintf(name, sizeof(name), "%llu", (unsigned long long)handle);
+            EventManager::call(listener, "timer", name);
+            // the callback may have cleared its own timer, only keep the overrun count when it's still there
+            if (listener.disabled)
+                wheel.cancel(handle);
+            else if ((timer = wheel.get(handle)))
+                timer->overruns = listener.overruns;
+        }
+        wheel.complete(handle);
+    }
+    due.clear();
+    if (expired.empty())
+        expired.swap(due);
+}
\ No newline at end of file
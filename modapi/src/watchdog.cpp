@@ -0,0 +1,96 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+
+void Watchdog::init()
+{
+    instructionbudget = Config::getint("lua.callback_budget_instructions", 5000000);
+    timebudget = std::chrono::milliseconds(Config::getint("lua.callback_budget_ms", 100));
+    maxoverruns = (std::max)(Config::getint("lua.callback_max_overruns", 3), 1);
+}
+
+void Watchdog::hook(lua_State* L, lua_Debug* ar)
+{
+    // coroutines created inside a callback inherit the hook and can outlive it
+    if (depth == 0) {
+        lua_sethook(L, nullptr, 0, 0);
+        return;
+    }
+    executed += CHECK_INTERVAL;
+    if (!overrun) {
+        bool outofinstructions = instructionbudget > 0 && executed >= instructionbudget;
+        bool outoftime = timebudget.count() > 0 && std::chrono::steady_clock::now() >= deadline;
+
+        if (!outofinstructions && !outoftime)
+            return;
+        overrun = true;
+    }
+    // from now on every instruction fails so the error gets out of any pcall loop
+    lua_sethook(L, hook, LUA_MASKCOUNT, 1);
+    luaL_error(L, "callback ran over its budget (%d instructions / %d ms)", (int)instructionbudget, (int)timebudget.count());
+}
+
+void Watchdog::begin(lua_State* L)
+{
+    // a callback started from another one runs on the budget of the outer one
+    if (depth++ > 0)
+        return;
+    executed = 0;
+    overrun = false;
+    deadline = std::chrono::steady_clock::now() + timebudget;
+    if (instructionbudget > 0 || timebudget.count() > 0)
+        lua_sethook(L, hook, LUA_MASKCOUNT, CHECK_INTERVAL);
+}
+
+bool Watchdog::end(lua_State* L)
+{
+    if (depth == 0 || --depth > 0)
+        return false;
+    lua_sethook(L, nullptr, 0, 0);
+    return overrun;
+}
+
+std::chrono::milliseconds Watchdog::remaining()
+{
+    if (depth == 0 || timebudget.count() <= 0)
+        return std::chrono::milliseconds::max();
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    return (std::max)(left, std::chrono::milliseconds(0));
+}
+
+int Watchdog::getmaxoverruns()
+{
+    return maxoverruns;
+}
\ No newline at end of file
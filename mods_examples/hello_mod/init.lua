@@ -1,4 +1,3 @@
-isingame = false
 assetchanged = false
 
 function get_every_assets_filepath()
@@ -9,25 +8,21 @@ function get_every_assets_filepath()
 	end
 end
 
-RegisterEvent("IsInGame", function()
-	isingame = true
-end)
-
-RegisterEvent("IsInMainMenu", function()
-	if assetchanged then return end
+RegisterEvent("OnPhaseChanged", function(phase, previous)
+	if phase ~= "mainmenu" or assetchanged then return end
 	--get_every_assets_filepath()
 	print("Asset changed!")
 	asset:SetAssetFilePath(0x2008, "mods/hello_mod/my_assets/custom_gof2_interface.aei") -- feel free to custom the gof2 interface with any tools (I don't know if we have any) also you can call this setassetfilepath function while the game is running BUT it won't be edited instantly, for the asset to be edited you need to 'reload' the game aka going to a station, changing system etc..
 	assetchanged = true
 end)
 
-RegisterEvent("OnMoneyChanged", function(money)
-	if not isingame then return end
-	print(money)
+RegisterEvent("OnMoneyChanged", function(money, old, tick, time)
+	if game.phase == "loading" or game.phase == "mainmenu" then return end
+	print(money .. " (" .. (money - old) .. ") at tick " .. tick)
 end)
 
 RegisterEvent("OnSystemChanged", function(id)
-	if not isingame then return end
+	if game.phase == "loading" or game.phase == "mainmenu" then return end
 	print("System id : " .. id)
 	print("System risk : " .. system.risk)
 	print("System faction : " .. system.faction)
@@ -44,7 +39,6 @@ RegisterEvent("OnSystemChanged", function(id)
 	print("Ship maxhealth : " .. player.maxhealth)
 	print("Enemies killed : " .. player.enemieskilled)
 	print("Player level : " .. player.level)
-	print("Player jump gate used count : " .. player.jumpgateusedcount)
 	print("Player visisted stations : " .. player.visitedstations)
 	print("Completed side missions : " .. mission.completedsidemissions)
 	print("Cargo took count : " .. player.cargotookcount)
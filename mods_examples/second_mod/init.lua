@@ -1,7 +1,7 @@
-printonetime = false
-
-RegisterEvent("IsInGame", function()
-	if printonetime then return end
+RegisterEvent("OnEnterGame", function()
 	print("hi second script")
-	printonetime = true
+end)
+
+RegisterEvent("OnDock", function()
+	print("docked at " .. station.name)
 end)
\ No newline at end of file
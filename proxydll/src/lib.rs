@@ -5,12 +5,15 @@ extern crate core;
 use winapi::shared::minwindef;
 use winapi::shared::minwindef::{BOOL, DWORD, HINSTANCE, LPVOID, UINT, MAX_PATH};
 use winapi::shared::d3d9;
-use winapi::um::winnt::{LPCSTR};
-use winapi::um::libloaderapi::{LoadLibraryA, GetProcAddress, GetModuleFileNameA};
+use winapi::um::libloaderapi::{LoadLibraryA, GetProcAddress, GetModuleFileNameA, DisableThreadLibraryCalls};
+use winapi::um::sysinfoapi::GetSystemDirectoryA;
 use winapi::um::consoleapi;
 use std::ptr;
 use std::ffi::CString;
 use std::mem;
+use std::fs;
+use std::thread;
+use std::sync::Once;
 use winapi::shared::d3d9::IDirect3D9;
 
 type _D3DCreate9 =  extern "stdcall" fn(UINT) -> *mut d3d9::IDirect3D9;
@@ -19,9 +22,12 @@ type _D3DPERF_SetOptions = extern "stdcall" fn(DWORD);
 static mut hOriginal: HINSTANCE = ptr::null_mut();
 static mut pDirect3DCreate9: Option<_D3DCreate9> = None;
 static mut pD3DPERF_SetOptions: Option<_D3DPERF_SetOptions> = None;
+static ORIGINAL: Once = Once::new();
+static MODAPI: Once = Once::new();
 
 #[no_mangle]
 pub unsafe extern "system" fn D3DPERF_SetOptions(dwOptions: DWORD) {
+    load_original();
     match pD3DPERF_SetOptions {
         Some(func) => func(dwOptions),
         None => panic!("SetOptions panic")
@@ -30,12 +36,16 @@ pub unsafe extern "system" fn D3DPERF_SetOptions(dwOptions: DWORD) {
 
 #[no_mangle]
 pub unsafe extern "stdcall" fn Direct3DCreate9(SDKVersion: UINT) -> *mut IDirect3D9 {
+    load_original();
+    load_modapi();
     match pDirect3DCreate9 {
         Some(func) => func(SDKVersion),
         None => panic!("Direct3DCreate9 panic")
     }
 }
 
+// Nothing is loaded under the loader lock, the system d3d9 is resolved on the first forwarded call
+// and the modapi is loaded on its own thread once the game creates its d3d9 object
 #[no_mangle]
 #[allow(non_snake_case, unused_variables)]
 extern "system" fn DllMain(dll_module: HINSTANCE, call_reason: DWORD, reserved: LPVOID) -> BOOL {
@@ -43,7 +53,7 @@ extern "system" fn DllMain(dll_module: HINSTANCE, call_reason: DWORD, reserved:
     const DLL_PROCESS_DETACH: DWORD = 0;
 
     match call_reason {
-        DLL_PROCESS_ATTACH => initialize(),
+        DLL_PROCESS_ATTACH => unsafe { DisableThreadLibraryCalls(dll_module); },
         DLL_PROCESS_DETACH => (),
         _ => ()
     }
@@ -51,42 +61,91 @@ extern "system" fn DllMain(dll_module: HINSTANCE, call_reason: DWORD, reserved:
     minwindef::TRUE
 }
 
-fn initialize() {
-    unsafe {
-        hOriginal = LoadLibraryA(CString::new("C:\\Windows\\System32\\d3d9.dll").unwrap().as_ptr());
-        
+fn load_original() {
+    ORIGINAL.call_once(|| unsafe {
+        let mut buffer = [0i8; MAX_PATH];
+        let len = GetSystemDirectoryA(buffer.as_mut_ptr(), MAX_PATH as u32) as usize;
+        let directory = if len > 0 && len < MAX_PATH {
+            let slice = std::slice::from_raw_parts(buffer.as_ptr() as *const u8, len);
+            String::from_utf8_lossy(slice).into_owned()
+        } else {
+            String::from("C:\\Windows\\System32")
+        };
+
+        hOriginal = LoadLibraryA(CString::new(format!("{}\\d3d9.dll", directory)).unwrap().as_ptr());
+
         if !hOriginal.is_null() {
             pDirect3DCreate9 = Some(mem::transmute(GetProcAddress(hOriginal, CString::new("Direct3DCreate9").unwrap().as_ptr())));
             pD3DPERF_SetOptions = Some(mem::transmute(GetProcAddress(hOriginal, CString::new("D3DPERF_SetOptions").unwrap().as_ptr())));
         } else {
             panic!("Couldn't find d3d9.dll on the system");
         }
+    });
+}
+
+// Same format as the modapi side: "key = value", # starts a comment, the last occurrence wins
+fn config_bool(key: &str, fallback: bool) -> bool {
+    let content = match fs::read_to_string("modapi.cfg") {
+        Ok(content) => content,
+        Err(_) => return fallback
+    };
+    let mut value = None;
+
+    for line in content.lines() {
+        let line = line.split('#').next().unwrap_or("");
+
+        if let Some((k, v)) = line.split_once('=') {
+            if k.trim() == key {
+                value = Some(v.trim().to_string());
+            }
+        }
+    }
+    match value {
+        Some(v) => v == "true" || v == "1" || v == "yes" || v == "on",
+        None => fallback
+    }
+}
 
+fn is_launcher() -> bool {
+    unsafe {
         let mut buffer = [0i8; MAX_PATH];
         let len = GetModuleFileNameA(ptr::null_mut(), buffer.as_mut_ptr(), MAX_PATH as u32);
-        
+
         if len > 0 {
             let slice = std::slice::from_raw_parts(buffer.as_ptr() as *const u8, len as usize);
             let path_str = String::from_utf8_lossy(slice).to_lowercase();
 
-            if path_str.contains("gof2launcher.exe") {
-                return;
-            }
+            return path_str.contains("gof2launcher.exe");
         }
+    }
+    false
+}
 
-        consoleapi::AllocConsole();
-        println!("[*] Loading KaamoClubModAPI...");
+fn load_modapi() {
+    MODAPI.call_once(|| {
+        if is_launcher() {
+            return;
+        }
+        // the game keeps starting while the modapi initializes
+        thread::spawn(|| unsafe {
+            let console = config_bool("console", true);
 
-        let payload_path = CString::new("kaamoclubmodapi.dll").unwrap();
-        
-        println!("[*] Loading core modapi dll...");
-        
-        let coremodapi = LoadLibraryA(payload_path.as_ptr());
+            if console {
+                consoleapi::AllocConsole();
+                println!("[*] Loading KaamoClubModAPI...");
+                println!("[*] Loading core modapi dll...");
+            }
 
-        if coremodapi.is_null() {
-            println!("[-] Failed to load the core modapi dll");
-        } else {
-            println!("[+] Successfully loaded core modapi dll at: {:?}", coremodapi);
-        }
-    }
-}
\ No newline at end of file
+            let payload_path = CString::new("kaamoclubmodapi.dll").unwrap();
+            let coremodapi = LoadLibraryA(payload_path.as_ptr());
+
+            if console {
+                if coremodapi.is_null() {
+                    println!("[-] Failed to load the core modapi dll");
+                } else {
+                    println!("[+] Successfully loaded core modapi dll at: {:?}", coremodapi);
+                }
+            }
+        });
+    });
+}
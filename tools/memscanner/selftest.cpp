@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "memscanner.h"
+
+// Runs the MemoryScanner against the memory of its own process: puts known int, float and UTF-16 values on the heap,
+// finds them with a first scan and narrows the results with changed/unchanged/exact passes like a mod would.
+// Prints the result count of every pass and exits with 1 when a value is lost or a pass keeps more than the one before.
+// A few results always survive in the stack of the scanning thread, it really changes between passes.
+// Builds on Windows (xmake build memscanner_selftest) and Linux:
+// g++ -std=c++20 -O2 -msse2 -Imodapi/include tools/memscanner/selftest.cpp modapi/src/memscanner.cpp -o selftest
+
+static int failures = 0;
+
+static bool contains(MemoryScanner& scanner, const void* address)
+{
+    std::vector<uintptr_t> found;
+
+    scanner.getresults(found, MemoryScanner::MAX_RESULTS);
+    return std::find(found.begin(), found.end(), (uintptr_t)address) != found.end();
+}
+
+static void check(const char* name, MemoryScanner& scanner, bool scanned, const void* address, size_t& previous)
+{
+    size_t count = scanner.count();
+    bool found = scanned && contains(scanner, address);
+    bool narrowed = count <= previous;
+
+    printf("%-32s %8zu results%s%s%s\n", name, count, scanner.istruncated() ? " (truncated)" : "", found ? "" : " FAIL: value lost", narrowed ? "" : " FAIL: more results than before");
+    if (!found || !narrowed)
+        failures++;
+    previous = count;
+}
+
+// Built at run time so the only UTF-16 copy is the one on the heap
+static std::u16string widen(const std::string& text)
+{
+    return std::u16string(text.begin(), text.end());
+}
+
+int main()
+{
+    // values unlikely to already be in memory, the constants themselves also sit in the code
+    auto number = std::make_unique<int32_t>(0x4B43 * 1000 + 7);
+    auto decimal = std::make_unique<float>(4312.625f);
+    std::string marker = std::string("KaamoClub") + "ScannerSelfTest";
+    auto text = std::make_unique<std::u16string>(widen(marker));
+    size_t previous = SIZE_MAX;
+
+    MemoryScanner ints(ScanType::Int);
+    auto start = std::chrono::steady_clock::now();
+    check("int exact", ints, ints.first(ScanCompare::Exact, *number, 0, ""), number.get(), previous);
+    printf("  first scan took %lld ms\n", (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    *number += 5;
+    check("int changed", ints, ints.next(ScanCompare::Changed, 0, 0, ""), number.get(), previous);
+    check("int unchanged", ints, ints.next(ScanCompare::Unchanged, 0, 0, ""), number.get(), previous);
+    *number = -123456;
+    check("int exact after a write", ints, ints.next(ScanCompare::Exact, *number, 0, ""), number.get(), previous);
+
+    previous = SIZE_MAX;
+    MemoryScanner floats(ScanType::Float);
+    check("float exact", floats, floats.first(ScanCompare::Exact, *decimal, 0, ""), decimal.get(), previous);
+    *decimal *= 2;
+    check("float changed", floats, floats.next(ScanCompare::Changed, 0, 0, ""), decimal.get(), previous);
+    check("float range", floats, floats.next(ScanCompare::Range, 8000, 9000, ""), decimal.get(), previous);
+
+    // same scan on the worker thread, the way the lua API runs them
+    previous = SIZE_MAX;
+    MemoryScanner strings(ScanType::WString);
+    strings.start([&](MemoryScanner& scanner) { return scanner.first(ScanCompare::Exact, 0, 0, marker); }, nullptr);
+    while (strings.isbusy()) {
+        MemoryScanner::dispatch();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    check("utf16 exact (worker)", strings, true, text->data(), previous);
+    (*text)[0] = u'k';
+    check("utf16 changed", strings, strings.next(ScanCompare::Changed, 0, 0, ""), text->data(), previous);
+    marker[0] = 'k';
+    check("utf16 exact after a write", strings, strings.next(ScanCompare::Exact, 0, 0, marker), text->data(), previous);
+    check("utf16 unchanged", strings, strings.next(ScanCompare::Unchanged, 0, 0, ""), text->data(), previous);
+
+    printf(failures ? "%d checks failed\n" : "all checks passed\n", failures);
+    return failures ? 1 : 0;
+}
\ No newline at end of file
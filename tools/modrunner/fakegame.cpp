@@ -0,0 +1,98 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+#include "fakegame.h"
+
+uintptr_t FakeGame::allocate(size_t size)
+{
+    blocks.push_back(std::make_unique<uint8_t[]>(size));
+    return (uintptr_t)blocks.back().get();
+}
+
+uintptr_t FakeGame::buildchain(uintptr_t address, const std::vector<unsigned int>& offsets)
+{
+    for (unsigned int offset : offsets) {
+        uintptr_t pointer = MemoryUtils::Read<uintptr_t>(address);
+        if (pointer == 0) {
+            pointer = allocate(NODE_SIZE);
+            MemoryUtils::Write<uintptr_t>(address, pointer);
+        }
+        address = pointer + offset;
+    }
+    return address;
+}
+
+// Same chains as GamePhase: first offset from GoF2.exe, the others followed.
+// Without a configured probe GamePhase guesses the phase as it does in game, with phase.heuristic = false the runner points it at its own probe.
+uintptr_t FakeGame::buildprobe(const std::string& key, unsigned int fallback)
+{
+    if (!Config::has(key) && !Config::getbool("phase.heuristic", true))
+        Config::set(key, std::to_string(fallback));
+    std::vector<unsigned int> chain = Config::getoffsets(key);
+    if (chain.empty() || chain[0] >= MODULE_SIZE)
+        return 0;
+    return buildchain(modulebase + chain[0], std::vector<unsigned int>(chain.begin() + 1, chain.end()));
+}
+
+void FakeGame::init()
+{
+    modulebase = allocate(MODULE_SIZE);
+    MemoryUtils::OverrideModuleBase("GoF2.exe", modulebase);
+}
+
+void FakeGame::build()
+{
+    for (const FieldInfo& info : FieldRegistry::fields)
+        buildchain(FieldRegistry::getroot(info.object), info.offsets);
+    FieldRegistry::write_wstring(FieldId::Station_name, "Fake Station");
+    gameobject = MemoryUtils::Read<uintptr_t>(FieldRegistry::getroot(FieldObject::Player));
+    ingameprobe = buildprobe("phase.ingame_probe", INGAME_PROBE);
+    dockedprobe = buildprobe("phase.docked_probe", DOCKED_PROBE);
+    setphase(Phase::MainMenu);
+}
+
+void FakeGame::setphase(Phase phase)
+{
+    uintptr_t root = FieldRegistry::getroot(FieldObject::Player);
+
+    MemoryUtils::Write<uintptr_t>(root, phase == Phase::Loading ? 0 : gameobject);
+    if (ingameprobe)
+        MemoryUtils::Write<int>(ingameprobe, GamePhase::isingame(phase) ? 1 : 0);
+    if (dockedprobe)
+        MemoryUtils::Write<int>(dockedprobe, phase == Phase::Docked ? 1 : 0);
+    // the game sets a mission when a game starts and doesn't clear it when going back to the menu
+    if (GamePhase::isingame(phase) && FieldRegistry::read_int(FieldId::Mission_id) <= 0)
+        FieldRegistry::write_int(FieldId::Mission_id, 1);
+}
\ No newline at end of file
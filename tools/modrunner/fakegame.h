@@ -0,0 +1,40 @@
+#ifndef FAKEGAME_H
+#define FAKEGAME_H
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fieldregistry.h"
+#include "gamephase.h"
+
+// Stand in for the GoF2 memory in the headless runner: a zeroed block posing as GoF2.exe (through MemoryUtils::OverrideModuleBase)
+// and one struct for every pointer the schema chains go through, so the FieldRegistry reads and writes it like the real game.
+// The phases are given by the phase.ingame_probe/phase.docked_probe ints (the runner's own ones when modapi.cfg has none and
+// phase.heuristic = false), the game object pointer is emptied while loading. Like the game, the mission id and the system/station pointers are left as they are
+// when going back to the menu or undocking, so phase.heuristic gets the same wrong answers as in game.
+class FakeGame {
+    private:
+        static constexpr size_t MODULE_SIZE = 0x210000;
+        static constexpr size_t NODE_SIZE = 0x1000;
+        // where the runner's probes go, past what the schema uses
+        static constexpr unsigned int INGAME_PROBE = 0x200000;
+        static constexpr unsigned int DOCKED_PROBE = 0x200004;
+        static inline std::vector<std::unique_ptr<uint8_t[]>> blocks;
+        static inline uintptr_t modulebase = 0;
+        // the game object while the root is emptied for loading
+        static inline uintptr_t gameobject = 0;
+        static inline uintptr_t ingameprobe = 0;
+        static inline uintptr_t dockedprobe = 0;
+
+        static uintptr_t allocate(size_t size);
+        // Follows offsets from address like MemoryUtils::GetPointerAddress, with a fresh struct wherever it would stop on a null pointer
+        static uintptr_t buildchain(uintptr_t address, const std::vector<unsigned int>& offsets);
+        static uintptr_t buildprobe(const std::string& key, unsigned int fallback);
+    public:
+        // Before the Game objects init, they take their roots from the fake module
+        static void init(void);
+        // After them and before GamePhase::init: creates the structs behind every field and probe, starts in the main menu
+        static void build(void);
+        static void setphase(Phase phase);
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+#include "timers.h"
+#include "fileio.h"
+#include "fakegame.h"
+#include "scenario.h"
+
+// Runs a mods folder against scripted scenarios without the game and reports what each mod cost.
+// modrunner [options] <scenario>...
+// --mods <folder>         mods to load (default mods)
+// --jobs <count>          scenarios running at the same time (default 4)
+// --max-callback-ms <ms>  fails when a single callback of a mod took longer
+// --max-mod-ms <ms>       fails when a mod spent more lua time per tick on average
+// --max-memory-kb <kb>    fails when a mod lua memory peaked higher
+// --max-allocations <n>   fails when a mod allocated more times
+// Every scenario runs in its own process (the modapi state is static) with the modapi.cfg of the current folder,
+// ticks follow each other without sleeping and the timers count 1/60 s per tick. Exits with 1 when a limit was exceeded, 2 when a scenario couldn't run.
+
+static constexpr auto TICK_PERIOD = std::chrono::microseconds(1000000 / 60);
+
+struct Limits {
+    double callbackms = 0;
+    double modms = 0;
+    double memorykb = 0;
+    double allocations = 0;
+};
+
+struct ModReport {
+    std::string name;
+    uint64_t calls;
+    int64_t time;
+    int64_t worst;
+    uint64_t allocations;
+    size_t peak;
+    int overruns;
+    std::string worstname;
+};
+
+struct Report {
+    std::string scenario;
+    uint64_t ticks = 0;
+    double cpums = 0;
+    // SetTimeout timers still waiting when the scenario ended, intervals aren't counted
+    size_t timeouts = 0;
+    std::vector<ModReport> mods;
+};
+
+static double getcpums(void)
+{
+    FILETIME creation, exited, kernel, user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exited, &kernel, &user))
+        return 0;
+    uint64_t total = ((uint64_t)kernel.dwHighDateTime << 32 | kernel.dwLowDateTime) + ((uint64_t)user.dwHighDateTime << 32 | user.dwLowDateTime);
+    // 100 ns units
+    return total / 10000.0;
+}
+
+static int runchild(const std::string& scenariopath, const std::string& reportpath, const std::string& modsfolder)
+{
+    Scenario scenario;
+    std::string error;
+
+    Config::load("modapi.cfg");
+    Logger::setlevel(Logger::parselevel(Config::getstring("log.level", "warning"), LogLevel::Warning));
+    Logger::start();
+    FakeGame::init();
+    Player::init();
+    System::init();
+    Station::init();
+    Mission::init();
+    Asset::init();
+    FieldRegistry::build();
+    FakeGame::build();
+    Galaxy::init();
+    GamePhase::init();
+    if (!scenario.load(scenariopath, error)) {
+        Logger::error("ModRunner", "{}", error);
+        Logger::stop();
+        return 2;
+    }
+    // the Storage writes stay in memory (the mods saves are read but never touched), no telemetry
+    // and the changes are sampled once per tick instead of on a thread
+    Storage::setpersistent(false);
+    Storage::start();
+    FileIO::start();
+    Timers::settickclock(TICK_PERIOD);
+    LuaManager *luamanager = new LuaManager();
+    luamanager->init();
+    luamanager->bind_api();
+    ModApiUtils::load_mods(luamanager, modsfolder);
+
+    uint64_t ticks = scenario.run([luamanager]() {
+        ChangeSampler::poll();
+        ModApiUtils::run_tick(luamanager, std::chrono::steady_clock::now() + TICK_PERIOD);
+    });
+
+    // tab separated, mod and callback names can have spaces
+    std::ofstream out(reportpath);
+    out << "ticks\t" << ticks << "\n";
+    out << "cpu\t" << getcpums() << "\n";
+    out << "timeouts\t" << Timers::countpending() << "\n";
+    for (int mod = 1; mod < (int)ModContext::count(); mod++) {
+        const EventManager::CallStats& calls = EventManager::getcallstats(mod);
+        const LuaAllocator::Stats& memory = LuaAllocator::getstats(mod);
+        out << "mod\t" << ModContext::getname(mod) << "\t" << calls.calls << "\t" << calls.time << "\t" << calls.worst << "\t"
+            << memory.allocations.load(std::memory_order_relaxed) << "\t" << memory.peak.load(std::memory_order_relaxed) << "\t"
+            << calls.overruns << "\t" << calls.worstname << "\n";
+    }
+    out.close();
+    FileIO::stop();
+    Storage::stop();
+    Logger::stop();
+    return out.fail() ? 2 : 0;
+}
+
+static bool readreport(const std::string& path, Report& report)
+{
+    std::ifstream file(path);
+    std::string line;
+    bool complete = false;
+
+    while (std::getline(file, line)) {
+        std::istringstream words(line);
+        std::vector<std::string> columns;
+        std::string column;
+        while (std::getline(words, column, '\t'))
+            columns.push_back(column);
+        if (columns.size() == 2 && columns[0] == "ticks") {
+            report.ticks = std::stoull(columns[1]);
+            complete = true;
+        } else if (columns.size() == 2 && columns[0] == "cpu") {
+            report.cpums = std::stod(columns[1]);
+        } else if (columns.size() == 2 && columns[0] == "timeouts") {
+            report.timeouts = (size_t)std::stoull(columns[1]);
+        } else if (columns.size() >= 8 && columns[0] == "mod") {
+            report.mods.push_back({ columns[1], std::stoull(columns[2]), std::stoll(columns[3]), std::stoll(columns[4]),
+                std::stoull(columns[5]), (size_t)std::stoull(columns[6]), std::stoi(columns[7]), columns.size() > 8 ? columns[8] : "" });
+        }
+    }
+    return complete;
+}
+
+// Prints the report of one scenario, returns false when a mod went over a limit
+static bool checkreport(const Report& report, const Limits& limits)
+{
+    bool passed = true;
+
+    printf("%s: %llu ticks, %.1f ms of cpu, %zu timeouts still pending\n", report.scenario.c_str(), (unsigned long long)report.ticks, report.cpums, report.timeouts);
+    printf("  %-24s %8s %10s %10s %10s %12s %10s  %s\n", "mod", "calls", "lua ms", "ms/tick", "worst ms", "allocations", "peak KB", "worst callback");
+    for (const ModReport& mod : report.mods) {
+        double luams = mod.time / 1000.0;
+        double tickms = report.ticks > 0 ? luams / report.ticks : 0;
+        double worstms = mod.worst / 1000.0;
+        double peakkb = mod.peak / 1024.0;
+        std::vector<std::string> failures;
+
+        printf("  %-24s %8llu %10.2f %10.4f %10.3f %12llu %10.1f  %s\n", mod.name.c_str(), (unsigned long long)mod.calls, luams, tickms, worstms,
+            (unsigned long long)mod.allocations, peakkb, mod.worstname.c_str());
+        if (mod.overruns > 0)
+            failures.push_back(std::to_string(mod.overruns) + " callbacks aborted by the watchdog");
+        if (limits.callbackms > 0 && worstms > limits.callbackms)
+            failures.push_back("worst callback over " + std::to_string(limits.callbackms) + " ms");
+        if (limits.modms > 0 && tickms > limits.modms)
+            failures.push_back("lua time per tick over " + std::to_string(limits.modms) + " ms");
+        if (limits.memorykb > 0 && peakkb > limits.memorykb)
+            failures.push_back("memory peak over " + std::to_string(limits.memorykb) + " KB");
+        if (limits.allocations > 0 && mod.allocations > limits.allocations)
+            failures.push_back("more than " + std::to_string((uint64_t)limits.allocations) + " allocations");
+        for (const std::string& failure : failures)
+            printf("    FAIL %s\n", failure.c_str());
+        passed = passed && failures.empty();
+    }
+    return passed;
+}
+
+static int runparent(const std::vector<std::string>& scenarios, const std::string& modsfolder, int jobs, const Limits& limits)
+{
+    struct Job {
+        PROCESS_INFORMATION process;
+        std::string scenario;
+        std::string report;
+    };
+    std::vector<Job> running;
+    char exepath[MAX_PATH];
+    char tempfolder[MAX_PATH];
+    size_t next = 0;
+    bool failed = false;
+    bool broken = false;
+
+    GetModuleFileNameA(NULL, exepath, MAX_PATH);
+    GetTempPathA(MAX_PATH, tempfolder);
+    while (next < scenarios.size() || !running.empty()) {
+        while (next < scenarios.size() && (int)running.size() < jobs) {
+            Job job = { {}, scenarios[next++], "" };
+            char reportpath[MAX_PATH];
+            STARTUPINFOA startup = { sizeof(startup) };
+
+            GetTempFileNameA(tempfolder, "kmr", 0, reportpath);
+            job.report = reportpath;
+            std::string commandline = "\"" + std::string(exepath) + "\" --child \"" + job.scenario + "\" --report \"" + job.report + "\" --mods \"" + modsfolder + "\"";
+            if (!CreateProcessA(NULL, commandline.data(), NULL, NULL, FALSE, 0, NULL, NULL, &startup, &job.process)) {
+                fprintf(stderr, "%s: can't start the runner (error %lu)\n", job.scenario.c_str(), GetLastError());
+                DeleteFileA(job.report.c_str());
+                broken = true;
+                continue;
+            }
+            running.push_back(job);
+        }
+        if (running.empty())
+            break;
+        std::vector<HANDLE> handles;
+        for (const Job& job : running)
+            handles.push_back(job.process.hProcess);
+        DWORD index = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, INFINITE) - WAIT_OBJECT_0;
+        if (index >= handles.size()) {
+            fprintf(stderr, "Waiting for the runners failed (error %lu)\n", GetLastError());
+            return 2;
+        }
+        Job job = running[index];
+        DWORD exitcode = 0;
+        Report report;
+        running.erase(running.begin() + index);
+        GetExitCodeProcess(job.process.hProcess, &exitcode);
+        CloseHandle(job.process.hProcess);
+        CloseHandle(job.process.hThread);
+        report.scenario = job.scenario;
+        if (exitcode != 0 || !readreport(job.report, report)) {
+            fprintf(stderr, "%s: the runner failed (exit code %lu)\n", job.scenario.c_str(), exitcode);
+            broken = true;
+        } else if (!checkreport(report, limits)) {
+            failed = true;
+        }
+        DeleteFileA(job.report.c_str());
+    }
+    if (broken)
+        return 2;
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> scenarios;
+    std::string modsfolder = "mods";
+    std::string child;
+    std::string reportpath;
+    Limits limits;
+    int jobs = 4;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasvalue = i + 1 < argc;
+        if (arg == "--mods" && hasvalue)
+            modsfolder = argv[++i];
+        // WaitForMultipleObjects takes at most 64 processes
+        else if (arg == "--jobs" && hasvalue)
+            jobs = (std::min)((std::max)(1, atoi(argv[++i])), MAXIMUM_WAIT_OBJECTS);
+        else if (arg == "--max-callback-ms" && hasvalue)
+            limits.callbackms = atof(argv[++i]);
+        else if (arg == "--max-mod-ms" && hasvalue)
+            limits.modms = atof(argv[++i]);
+        else if (arg == "--max-memory-kb" && hasvalue)
+            limits.memorykb = atof(argv[++i]);
+        else if (arg == "--max-allocations" && hasvalue)
+            limits.allocations = atof(argv[++i]);
+        else if (arg == "--child" && hasvalue)
+            child = argv[++i];
+        else if (arg == "--report" && hasvalue)
+            reportpath = argv[++i];
+        else if (arg.rfind("--", 0) != 0)
+            scenarios.push_back(arg);
+        else {
+            fprintf(stderr, "Unknown option or missing value: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+    if (!child.empty())
+        return runchild(child, reportpath, modsfolder);
+    if (scenarios.empty()) {
+        fprintf(stderr, "usage: modrunner [--mods <folder>] [--jobs <count>] [--max-callback-ms <ms>] [--max-mod-ms <ms>] [--max-memory-kb <kb>] [--max-allocations <count>] <scenario>...\n");
+        return 2;
+    }
+    return runparent(scenarios, modsfolder, jobs, limits);
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <windows.h>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <tlhelp32.h>
+#include <vector>
+#include <sol/sol.hpp>
+#include <map>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include "modapi_utils.h"
+#include "luamanager.h"
+#include "memoryutils.h"
+#include "eventmanager.h"
+#include "fieldregistry.h"
+#include "config.h"
+#include "logger.h"
+#include "modcontext.h"
+#include "luaallocator.h"
+#include "serializer.h"
+#include "seqlock.h"
+#include "galaxy.h"
+#include "watchdog.h"
+#include "storage.h"
+#include "gamephase.h"
+#include "memscanner.h"
+#include "telemetry.h"
+#include "memorybuffer.h"
+#include "changesampler.h"
+#include "fieldseries.h"
+#include <Game/player.h>
+#include <Game/system.h>
+#include <Game/station.h>
+#include <Game/mission.h>
+#include <Game/asset.h>
+#include "fakegame.h"
+#include "scenario.h"
+
+bool Scenario::load(const std::string& path, std::string& error)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::vector<size_t> repeats;
+    int number = 0;
+
+    if (!file.is_open()) {
+        error = "can't open " + path;
+        return false;
+    }
+    steps.clear();
+    while (std::getline(file, line)) {
+        number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        std::istringstream words(line);
+        std::string command;
+        std::string argument;
+        Step step = { Op::Ticks, FieldId::Count, 0, Phase::Loading, 0 };
+        if (!(words >> command))
+            continue;
+        bool valid = true;
+        if (command == "ticks" || command == "repeat") {
+            step.op = command == "ticks" ? Op::Ticks : Op::Repeat;
+            valid = (bool)(words >> step.value) && step.value >= 0;
+            if (step.op == Op::Repeat)
+                repeats.push_back(steps.size());
+        } else if (command == "set" || command == "add") {
+            step.op = command == "set" ? Op::Set : Op::Add;
+            valid = (bool)(words >> argument >> step.value);
+            step.field = FieldRegistry::find(argument);
+            valid = valid && step.field != FieldId::Count && FieldRegistry::fields[(size_t)step.field].type == FieldType::Int;
+        } else if (command == "jump") {
+            step.op = Op::Set;
+            step.field = FieldId::System_id;
+            valid = (bool)(words >> step.value);
+        } else if (command == "phase") {
+            step.op = Op::Phase;
+            valid = false;
+            words >> argument;
+            for (Phase phase : { Phase::Loading, Phase::MainMenu, Phase::InSpace, Phase::Docked }) {
+                if (argument == GamePhase::getname(phase)) {
+                    step.phase = phase;
+                    valid = true;
+                }
+            }
+        } else if (command == "end" && !repeats.empty()) {
+            step.op = Op::End;
+            step.match = repeats.back();
+            steps[repeats.back()].match = steps.size();
+            repeats.pop_back();
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            error = path + ":" + std::to_string(number) + ": can't understand '" + line + "'";
+            return false;
+        }
+        steps.push_back(step);
+    }
+    if (!repeats.empty()) {
+        error = path + ": repeat without end";
+        return false;
+    }
+    return true;
+}
+
+uint64_t Scenario::run(const std::function<void()>& tick)
+{
+    // repeat step index, iterations left
+    std::vector<std::pair<size_t, int64_t>> loops;
+    uint64_t ticks = 0;
+
+    for (size_t i = 0; i < steps.size(); i++) {
+        const Step& step = steps[i];
+        switch (step.op) {
+        case Op::Ticks:
+            for (int64_t j = 0; j < step.value; j++)
+                tick();
+            ticks += step.value;
+            break;
+        case Op::Set:
+            FieldRegistry::write_int(step.field, (int)step.value);
+            break;
+        case Op::Add:
+            FieldRegistry::write_int(step.field, FieldRegistry::read_int(step.field) + (int)step.value);
+            break;
+        case Op::Phase:
+            FakeGame::setphase(step.phase);
+            break;
+        case Op::Repeat:
+            if (step.value > 0)
+                loops.push_back({ i, step.value });
+            else
+                i = step.match;
+            break;
+        case Op::End:
+            if (--loops.back().second > 0) {
+                i = loops.back().first;
+            } else {
+                loops.pop_back();
+            }
+            break;
+        }
+    }
+    return ticks;
+}
\ No newline at end of file
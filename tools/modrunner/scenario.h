@@ -0,0 +1,33 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "fieldregistry.h"
+#include "gamephase.h"
+
+// Script of game events for the headless runner, one command per line (# starts a comment):
+// ticks <count>              runs that many ticks
+// set <object.field> <value> writes an int field, add <object.field> <delta> adds to it
+// jump <system id>           same as set system.id
+// phase <loading|mainmenu|inspace|docked>
+// repeat <count> ... end     runs the lines in between count times, can be nested
+class Scenario {
+    private:
+        enum class Op { Ticks, Set, Add, Phase, Repeat, End };
+        struct Step {
+            Op op;
+            FieldId field;
+            int64_t value;
+            Phase phase;
+            // index of the matching end for repeat
+            size_t match;
+        };
+        std::vector<Step> steps;
+    public:
+        bool load(const std::string& path, std::string& error);
+        // Calls tick for every tick of the script, returns how many ticks ran
+        uint64_t run(const std::function<void()>& tick);
+};
+#endif
\ No newline at end of file
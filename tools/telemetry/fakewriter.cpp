@@ -0,0 +1,95 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "telemetrylayout.h"
+#include <Game/fields.h>
+
+// Stand in for the modapi to try the readers without the game: publishes the real field table at 60 Hz
+// with values that move a bit every tick and prints the commands it receives.
+// fakewriter [ticks]   stops after that many ticks, runs until Ctrl+C otherwise
+
+struct FakeField {
+    const char* object;
+    const char* name;
+    uint32_t type;
+};
+
+#define FAKEWRITER_TYPE_int TELEMETRY_INT
+#define FAKEWRITER_TYPE_wstring TELEMETRY_STRING
+#define FAKEWRITER_FIELD(object, name, luaname, type, ...) { #object, luaname, FAKEWRITER_TYPE_##type },
+static const FakeField fakefields[] = { MODAPI_FIELDS(FAKEWRITER_FIELD) };
+#undef FAKEWRITER_FIELD
+
+static std::atomic<bool> running{ true };
+
+static void onsignal(int)
+{
+    running = false;
+}
+
+int main(int argc, char** argv)
+{
+    SharedMemory memory;
+    long long maxticks = argc > 1 ? atoll(argv[1]) : 0;
+    uint32_t ints = 0;
+    uint32_t strings = 0;
+
+    // a killed run leaves its object behind, start from a fresh one rather than from its field table
+    SharedMemory::remove(TELEMETRY_NAME);
+    if (!memory.open(TELEMETRY_NAME, sizeof(TelemetryBuffer), true)) {
+        fprintf(stderr, "Can't create the shared memory %s\n", TELEMETRY_NAME);
+        return 1;
+    }
+    signal(SIGINT, onsignal);
+    TelemetryBuffer* buffer = (TelemetryBuffer*)memory.get();
+    buffer->init(telemetryprocess());
+    for (const FakeField& fake : fakefields) {
+        TelemetryField& field = buffer->fields[buffer->fieldcount++];
+        snprintf(field.object, sizeof(field.object), "%s", fake.object);
+        snprintf(field.name, sizeof(field.name), "%s", fake.name);
+        field.type = fake.type;
+        field.index = fake.type == TELEMETRY_STRING ? strings++ : ints++;
+    }
+    buffer->magic.store(TELEMETRY_MAGIC, std::memory_order_release);
+    printf("Publishing %u fields to %s\n", buffer->fieldcount, TELEMETRY_NAME);
+
+    auto period = std::chrono::microseconds(1000000 / 60);
+    auto next = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; running && (maxticks <= 0 || tick < maxticks); tick++) {
+        char text[TELEMETRY_COMMAND_SIZE + 1];
+        size_t size;
+        while (buffer->popcommand(text, size)) {
+            text[size] = '\0';
+            printf("command: %s\n", text);
+        }
+
+        TelemetrySnapshot& snapshot = buffer->beginpublish();
+        snapshot.tick = tick;
+        // docked for 5 seconds, in space for 5 seconds
+        snapshot.phase = (tick / 300) % 2 ? 2 : 3;
+        snapshot.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        snapshot.validmask = 0;
+        for (uint32_t i = 0; i < buffer->fieldcount; i++) {
+            const TelemetryField& field = buffer->fields[i];
+            if (field.type == TELEMETRY_STRING) {
+                snprintf(snapshot.strings[field.index], TELEMETRY_STRING_SIZE, snapshot.phase == 3 ? "Fake Station %u" : "", tick / 600);
+                if (snapshot.phase == 3)
+                    snapshot.validmask |= 1ull << i;
+            } else {
+                snapshot.ints[field.index] = (int32_t)(i * 1000 + tick % 1000);
+                snapshot.validmask |= 1ull << i;
+            }
+        }
+        buffer->endpublish();
+
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    buffer->magic.store(0, std::memory_order_release);
+    memory.close();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "telemetrylayout.h"
+
+// Prints the game state published by the modapi (telemetry.enabled = true in modapi.cfg) or by fakewriter.
+// reader            prints the newest snapshot twice per second
+// reader --once     prints it once and exits
+// reader <command>  sends <command> to the mods (OnTelemetryCommand) and exits
+
+static const char* phasenames[] = { "loading", "mainmenu", "inspace", "docked" };
+
+static std::string format(const TelemetryBuffer& buffer, const TelemetrySnapshot& snapshot)
+{
+    char text[128];
+    std::string line;
+
+    snprintf(text, sizeof(text), "tick %u %s", snapshot.tick, snapshot.phase < 4 ? phasenames[snapshot.phase] : "?");
+    line = text;
+    for (uint32_t i = 0; i < buffer.fieldcount && i < TELEMETRY_MAX_FIELDS; i++) {
+        const TelemetryField& field = buffer.fields[i];
+        if (!(snapshot.validmask & (1ull << i)))
+            snprintf(text, sizeof(text), " %.16s.%.32s=-", field.object, field.name);
+        else if (field.type == TELEMETRY_STRING && field.index < TELEMETRY_MAX_STRINGS)
+            snprintf(text, sizeof(text), " %.16s.%.32s=\"%.64s\"", field.object, field.name, snapshot.strings[field.index]);
+        else if (field.index < TELEMETRY_MAX_FIELDS)
+            snprintf(text, sizeof(text), " %.16s.%.32s=%d", field.object, field.name, snapshot.ints[field.index]);
+        line += text;
+    }
+    return line;
+}
+
+int main(int argc, char** argv)
+{
+    SharedMemory memory;
+    bool once = argc > 1 && strcmp(argv[1], "--once") == 0;
+
+    if (!memory.open(TELEMETRY_NAME, sizeof(TelemetryBuffer), false)) {
+        fprintf(stderr, "Nothing publishes telemetry (%s)\n", TELEMETRY_NAME);
+        return 1;
+    }
+    TelemetryBuffer* buffer = (TelemetryBuffer*)memory.get();
+    if (!buffer->isready()) {
+        fprintf(stderr, "Telemetry isn't ready or has another layout version\n");
+        return 1;
+    }
+    if (argc > 1 && !once) {
+        std::string command = argv[1];
+        for (int i = 2; i < argc; i++)
+            command += std::string(" ") + argv[i];
+        if (!buffer->pushcommand(command.c_str(), command.size())) {
+            fprintf(stderr, "The command queue is full or the command is too long\n");
+            return 1;
+        }
+        return 0;
+    }
+    uint32_t lastpublished = buffer->published.load(std::memory_order_acquire);
+    for (;;) {
+        std::string line;
+        // the snapshot is formatted straight from the shared memory, a retry only happens if the writer lapped the whole ring
+        if (!buffer->readlatest([&](const TelemetrySnapshot& snapshot) { line = format(*buffer, snapshot); }))
+            line = "nothing published yet";
+        uint32_t published = buffer->published.load(std::memory_order_acquire);
+        printf("[+%u] %s\n", published - lastpublished, line.c_str());
+        fflush(stdout);
+        lastpublished = published;
+        if (once || !buffer->isready())
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    memory.close();
+    return 0;
+}
\ No newline at end of file
@@ -32,7 +32,7 @@ target("kaamoclubmodapi")
     add_files("modapi/src/Game/*.cpp")
     add_includedirs("modapi/include")
     add_packages("lua", "sol2")
-    add_syslinks("user32")
+    add_syslinks("user32", "winmm")
     set_languages("c++20")
 
     after_build(function (target)
@@ -44,4 +44,41 @@ target("kaamoclubmodapi")
         os.tryrm("build/.objs")
         os.tryrm("build/windows")
         os.tryrm("build/kaamoclubmodapi.dll")
-    end)
\ No newline at end of file
+    end)
+
+-- Telemetry tools, not built by default: xmake build telemetry_reader
+-- They also build on Linux without xmake: g++ -std=c++20 -Imodapi/include tools/telemetry/reader.cpp -o telemetry_reader
+target("telemetry_reader")
+    set_kind("binary")
+    set_default(false)
+    add_files("tools/telemetry/reader.cpp")
+    add_includedirs("modapi/include")
+    set_languages("c++20")
+
+target("telemetry_fakewriter")
+    set_kind("binary")
+    set_default(false)
+    add_files("tools/telemetry/fakewriter.cpp")
+    add_includedirs("modapi/include")
+    set_languages("c++20")
+
+
+-- Scans its own memory with the MemoryScanner, also builds on Linux (see tools/memscanner/selftest.cpp)
+target("memscanner_selftest")
+    set_kind("binary")
+    set_default(false)
+    add_files("tools/memscanner/selftest.cpp", "modapi/src/memscanner.cpp")
+    add_includedirs("modapi/include")
+    set_languages("c++20")
+
+-- Headless mod runner, not built by default: xmake build modrunner
+target("modrunner")
+    set_kind("binary")
+    set_default(false)
+    add_files("modapi/src/*.cpp|main.cpp")
+    add_files("modapi/src/Game/*.cpp")
+    add_files("tools/modrunner/*.cpp")
+    add_includedirs("modapi/include", "tools/modrunner")
+    add_packages("lua", "sol2")
+    add_syslinks("user32", "winmm")
+    set_languages("c++20")
\ No newline at end of file